@@ -0,0 +1,221 @@
+from __future__ import annotations
+
+import argparse
+import json
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+from typing_extensions import Dict, List, Optional, Sequence, Tuple, TypedDict, TYPE_CHECKING
+
+from package import AnytimeJSON, MILPResultJSON, ROOT, load_milp_results, load_result_lines
+
+
+class Namespace(argparse.Namespace):
+    if TYPE_CHECKING:
+        problems: List[str]
+        seeds: List[int]
+        checkpoints: List[float]
+        executable: Path
+        report: Path
+
+
+class RunReport(TypedDict):
+    seed: int
+    iterations: int
+    elapsed: float
+    working_time: Optional[float]
+    first_feasible: Optional[float]
+    at: Dict[str, Optional[float]]
+    gap_at: Dict[str, Optional[float]]
+    auc_time: float
+    auc_iterations: float
+
+
+class ProblemReport(TypedDict):
+    reference: Optional[float]
+    reference_source: str
+    mean_working_time: Optional[float]
+    mean_at: Dict[str, Optional[float]]
+    mean_gap_at: Dict[str, Optional[float]]
+    mean_auc_time: float
+    mean_auc_iterations: float
+    runs: List[RunReport]
+
+
+parser = argparse.ArgumentParser(
+    description="Quality-versus-time benchmark of the tabu search against the MILP reference results. "
+    "Arguments after \"--\" are passed to the executable.",
+    formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+)
+parser.add_argument("problems", nargs="+", type=str, help="the problem names")
+parser.add_argument("--seeds", nargs="+", default=[0, 1, 2], type=int, help="the random seeds of the runs of each problem")
+parser.add_argument("--checkpoints", nargs="+", default=[1.0, 5.0, 10.0, 30.0, 60.0], type=float, help="the wall-clock times (in seconds) to report the best solution at, the largest one is the AUC horizon")
+parser.add_argument("--executable", default=ROOT / "build" / "main.exe", type=Path, help="the tabu search executable")
+parser.add_argument("--report", default=ROOT / "result" / "benchmark.json", type=Path, help="the output report path")
+
+
+def best_at(profile: Sequence[Tuple[float, float]], x: float) -> Optional[float]:
+    """Best working time at `x` in an anytime profile of (x, working time) pairs sorted by x"""
+    result: Optional[float] = None
+    for point, working_time in profile:
+        if point > x:
+            break
+
+        result = working_time
+
+    return result
+
+
+def primal_gap(working_time: Optional[float], reference: float) -> float:
+    """Normalized primal gap in [0, 1], 1 without a feasible solution"""
+    if working_time is None:
+        return 1.0
+
+    if working_time <= reference:
+        return 0.0
+
+    return (working_time - reference) / working_time
+
+
+def primal_integral(profile: Sequence[Tuple[float, float]], reference: float, horizon: float) -> float:
+    """Average primal gap over [0, horizon], i.e. the area under the gap curve divided by the horizon"""
+    if horizon <= 0:
+        return primal_gap(best_at(profile, 0), reference)
+
+    area = 0.0
+    last, gap = 0.0, 1.0
+    for point, working_time in profile:
+        if point >= horizon:
+            break
+
+        area += gap * (point - last)
+        last, gap = point, primal_gap(working_time, reference)
+
+    area += gap * (horizon - last)
+    return area / horizon
+
+
+def relative_gap(working_time: Optional[float], reference: Optional[float]) -> Optional[float]:
+    """Gap to the reference in percent, negative when the reference is improved"""
+    if working_time is None or reference is None or reference <= 0:
+        return None
+
+    return round(100 * (working_time - reference) / reference, 4)
+
+
+def mean(values: Sequence[Optional[float]]) -> Optional[float]:
+    if not values or any(value is None for value in values):
+        return None
+
+    return round(sum(value for value in values if value is not None) / len(values), 4)
+
+
+def run(namespace: Namespace, problem: str, seed: int, extra: List[str]) -> Tuple[List[AnytimeJSON], int, float]:
+    with tempfile.TemporaryDirectory() as directory:
+        output = Path(directory) / f"{problem}-{seed}.jsonl"
+        subprocess.run(
+            [str(namespace.executable), problem, "--seed", str(seed), "--output", str(output), *extra],
+            check=True,
+            cwd=ROOT,
+            stdout=subprocess.DEVNULL,
+            stderr=subprocess.DEVNULL,
+        )
+
+        data = load_result_lines(output)
+
+    return data.get("anytime", []), data["iterations"], data["elapsed"]
+
+
+def milp_reference(milp: Dict[str, MILPResultJSON], problem: str) -> Optional[float]:
+    result = milp.get(problem)
+    if result is None or result["status"] == "INFEASIBLE":
+        return None
+
+    return result["Optimal"]  # type: ignore
+
+
+if __name__ == "__main__":
+    arguments = sys.argv[1:]
+    separator = arguments.index("--") if "--" in arguments else len(arguments)
+    extra = arguments[separator + 1:]
+
+    namespace = Namespace()
+    parser.parse_args(arguments[:separator], namespace=namespace)
+
+    milp_directory = ROOT / "problems" / "milp"
+    milp = load_milp_results(milp_directory) if milp_directory.is_dir() else {}
+    checkpoints = sorted(namespace.checkpoints)
+    horizon = checkpoints[-1]
+
+    report: Dict[str, ProblemReport] = {}
+    for problem in namespace.problems:
+        profiles: List[Tuple[int, List[AnytimeJSON], int, float]] = []
+        for seed in namespace.seeds:
+            print(f"Running {problem} with seed {seed}", file=sys.stderr)
+            profiles.append((seed, *run(namespace, problem, seed, extra)))
+
+        # Without a MILP result, gaps are relative to the best solution of this benchmark, so that they are
+        # only comparable between reports through the absolute working times
+        reference = milp_reference(milp, problem)
+        reference_source = "milp"
+        if reference is None:
+            found = [anytime[-1]["working_time"] for _, anytime, _, _ in profiles if anytime]
+            reference = min(found) if found else None
+            reference_source = "best" if found else "none"
+
+        max_iterations = max(iterations for _, _, iterations, _ in profiles)
+
+        runs: List[RunReport] = []
+        for seed, anytime, iterations, elapsed in profiles:
+            by_time = [(point["elapsed"], point["working_time"]) for point in anytime]
+            by_iteration = [(float(point["iteration"]), point["working_time"]) for point in anytime]
+            at = {f"{checkpoint:g}": best_at(by_time, checkpoint) for checkpoint in checkpoints}
+
+            runs.append(
+                {
+                    "seed": seed,
+                    "iterations": iterations,
+                    "elapsed": elapsed,
+                    "working_time": anytime[-1]["working_time"] if anytime else None,
+                    "first_feasible": anytime[0]["elapsed"] if anytime else None,
+                    "at": at,
+                    "gap_at": {key: relative_gap(value, reference) for key, value in at.items()},
+                    "auc_time": round(primal_integral(by_time, reference, horizon), 6) if reference is not None else 1.0,
+                    "auc_iterations": round(primal_integral(by_iteration, reference, max_iterations), 6) if reference is not None else 1.0,
+                }
+            )
+
+        report[problem] = {
+            "reference": reference,
+            "reference_source": reference_source,
+            "mean_working_time": mean([r["working_time"] for r in runs]),
+            "mean_at": {key: mean([r["at"][key] for r in runs]) for key in runs[0]["at"]},
+            "mean_gap_at": {key: mean([r["gap_at"][key] for r in runs]) for key in runs[0]["gap_at"]},
+            "mean_auc_time": round(sum(r["auc_time"] for r in runs) / len(runs), 6),
+            "mean_auc_iterations": round(sum(r["auc_iterations"] for r in runs) / len(runs), 6),
+            "runs": runs,
+        }
+
+    namespace.report.parent.mkdir(parents=True, exist_ok=True)
+    with namespace.report.open("w", encoding="utf-8") as file:
+        json.dump(
+            {
+                "seeds": namespace.seeds,
+                "checkpoints": checkpoints,
+                "arguments": extra,
+                "problems": report,
+            },
+            file,
+            indent=2,
+        )
+        file.write("\n")
+
+    header = f"{'Problem':<12} {'Reference':>12} {'Source':>6}" + "".join(f" {f'@{c:g}s':>12}" for c in checkpoints) + f" {'AUC(time)':>10} {'AUC(iter)':>10}"
+    print(header)
+    for problem, data in report.items():
+        cells = "".join(f" {'-' if value is None else f'{value:.2f}':>12}" for value in data["mean_at"].values())
+        reference_cell = "-" if data["reference"] is None else f"{data['reference']:.2f}"
+        print(f"{problem:<12} {reference_cell:>12} {data['reference_source']:>6}{cells} {data['mean_auc_time']:>10.4f} {data['mean_auc_iterations']:>10.4f}")
+
+    print(f"Report written to {namespace.report}", file=sys.stderr)
@@ -17,7 +17,7 @@ if "%1"=="alglib" (
 
 ) else (
     echo Building main.exe
-    set params=-Wall -I src/include -I extern/alglib-cpp/src -std=c++20
+    set params=-Wall -pthread -I src/include -I extern/alglib-cpp/src -std=c++20
     if "%1"=="debug" (
         set params=!params! -g -D DEBUG
         echo Building in debug mode
@@ -32,10 +32,24 @@ if "%1"=="alglib" (
             set params=!params! -fprofile-use
             echo Building using generated profile data
 
+        ) else if "%1"=="track-allocations" (
+            set params=!params! -D TRACK_ALLOCATIONS
+            echo Building with allocation tracking
+
         ) else echo Building normally
     )
 
     set command=g++ !params! %root%/src/main.cpp %root%/build/*.o -o %root%/build/main.exe
     echo Running "!command!"
     !command!
+
+    echo Building convert.exe
+    set command=g++ !params! %root%/src/convert.cpp %root%/build/*.o -o %root%/build/convert.exe
+    echo Running "!command!"
+    !command!
+
+    echo Building bench.exe
+    set command=g++ !params! %root%/src/bench.cpp %root%/build/*.o -o %root%/build/bench.exe
+    echo Running "!command!"
+    !command!
 )
@@ -21,7 +21,7 @@ then
 
 else
     echo "Building main.exe"
-    params="-Wall -I src/include -I extern/alglib-cpp/src -std=c++20"
+    params="-Wall -pthread -I src/include -I extern/alglib-cpp/src -std=c++20"
     if [ "$1" == "debug" ]
     then
         params="$params -g -D DEBUG"
@@ -39,6 +39,11 @@ else
             params="$params -fprofile-use"
             echo "Building using generated profile data"
 
+        elif [ "$1" == "track-allocations" ]
+        then
+            params="$params -D TRACK_ALLOCATIONS"
+            echo "Building with allocation tracking"
+
         else
             echo "Building normally"
 
@@ -50,4 +55,14 @@ else
     echo "Running \"$command\""
     $command
 
+    echo "Building convert.exe"
+    command="g++ $params $ROOT_DIR/src/convert.cpp $ROOT_DIR/build/*.o -o $ROOT_DIR/build/convert.exe"
+    echo "Running \"$command\""
+    $command
+
+    echo "Building bench.exe"
+    command="g++ $params $ROOT_DIR/src/bench.cpp $ROOT_DIR/build/*.o -o $ROOT_DIR/build/bench.exe"
+    echo "Running \"$command\""
+    $command
+
 fi
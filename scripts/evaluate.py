@@ -128,7 +128,7 @@ if __name__ == "__main__":
             model.drone_speed,
         )
 
-    print(data["max_elite_size"], data["reset_after_factor"], data["destroy_rate"])
+    print(data["strategy"], -1, data["max_elite_size"], data["reset_after_factor"], data["destroy_rate"], -1, "best", 1, -1, 10, -1, -1, 1)
     print(1)  # In evaluation mode
 
     def print_routes(routes: List[List[int]]) -> None:
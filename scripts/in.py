@@ -24,11 +24,19 @@ class Namespace(argparse.Namespace):
         trucks_count: int
         drones_count: int
         waiting_time_limit: float
-        strategy: Literal["random", "cyclic", "vns"]
+        strategy: Literal["random", "cyclic", "vns", "adaptive"]
         fix_iteration: int
         reset_after_factor: int
         max_elite_size: int
         destroy_rate: int
+        time_limit: float
+        scan_policy: Literal["auto", "best", "first", "sampled"]
+        sample_rate: float
+        critical_focus: float
+        critical_period: int
+        gap_limit: float
+        stagnation_gain: float
+        stagnation_spread: float
         verbose: bool
 
 
@@ -44,7 +52,7 @@ parser.add_argument("--range-type", default="high", choices=["low", "high"], hel
 parser.add_argument("--trucks-count", default=-1, type=int, help="the number of trucks to override, pass a negative value to use default")
 parser.add_argument("--drones-count", default=-1, type=int, help="the number of drones to override, pass a negative value to use default")
 parser.add_argument("--waiting-time-limit", type=float, default=3600, help="the waiting time limit for each customer")
-parser.add_argument("--strategy", default="random", choices=["random", "cyclic", "vns"], help="tabu search neighborhood selection strategy")
+parser.add_argument("--strategy", default="random", choices=["random", "cyclic", "vns", "adaptive"], help="tabu search neighborhood selection strategy, \"adaptive\" favors the neighborhoods with the highest recent cost decrease per second")
 parser.add_argument(
     "--fix-iteration",
     default=-1,
@@ -54,6 +62,34 @@ parser.add_argument(
 parser.add_argument("--reset-after-factor", default=30, type=int, help="the number of non-improved iterations before resetting the current solution = a2 * base")
 parser.add_argument("--max-elite-size", default=10, type=int, help="the maximum size of the elite set = a3")
 parser.add_argument("--destroy-rate", default=0, type=int, help="the perentage of an elite solution to destroy = a4")
+parser.add_argument("--time-limit", default=-1, type=float, help="the wall-clock time limit in seconds (the last 10%% is left to post-optimization), pass a non-positive value for no limit")
+parser.add_argument("--scan-policy", default="auto", choices=["auto", "best", "first", "sampled"], help="how much of a neighborhood each tabu search iteration explores, \"auto\" selects it from the number of customers")
+parser.add_argument("--sample-rate", default=0.25, type=float, help="the fraction of neighborhood candidates evaluated by the \"sampled\" scan policy")
+parser.add_argument(
+    "--critical-focus",
+    default=-1,
+    type=float,
+    help="only search inter-route moves involving a vehicle whose working time is within this fraction of the makespan, or whose routes violate a constraint, pass a negative value to search every vehicle pair",
+)
+parser.add_argument("--critical-period", default=10, type=int, help="the number of tabu search iterations between full inter-route scans when --critical-focus is set")
+parser.add_argument(
+    "--gap-limit",
+    default=-1,
+    type=float,
+    help="stop the tabu search once the relative gap (wt - lb) / wt between the best feasible working time wt and a lower bound lb is at most this value, pass a negative value to disable",
+)
+parser.add_argument(
+    "--stagnation-gain",
+    default=-1,
+    type=float,
+    help="at each tabu search reset, stop (or first switch from best- to first-improvement scans) when the expected relative improvement over the next reset period is below this value, pass a negative value to disable",
+)
+parser.add_argument(
+    "--stagnation-spread",
+    default=1,
+    type=float,
+    help="keep searching while the mean Hamming distance between elite solutions, relative to the number of customers, exceeds this value (1 to ignore diversity)",
+)
 parser.add_argument("-v", "--verbose", action="store_true", help="the verbose mode")
 
 
@@ -81,7 +117,7 @@ if __name__ == "__main__":
     else:
         raise RuntimeError("Cannot find a satisfying model from list", models)
 
-    for index in range(problem.customers_count):
+    for index in range(1, problem.customers_count + 1):
         problem.dronable[index] = problem.dronable[index] and problem.demands[index] <= model.capacity
 
     if isinstance(model, DroneEnduranceConfig):
@@ -156,5 +192,13 @@ if __name__ == "__main__":
         namespace.max_elite_size,
         namespace.reset_after_factor if namespace.fix_iteration < 0 else namespace.fix_iteration,
         namespace.destroy_rate,
+        namespace.time_limit,
+        namespace.scan_policy,
+        namespace.sample_rate,
+        namespace.critical_focus,
+        namespace.critical_period,
+        namespace.gap_limit,
+        namespace.stagnation_gain,
+        namespace.stagnation_spread,
     )
     print(0)  # Not in evaluation
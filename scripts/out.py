@@ -6,6 +6,7 @@ import os
 import random
 import string
 import textwrap
+from pathlib import Path
 from typing_extensions import List, Optional, Tuple
 
 from package import (
@@ -17,6 +18,7 @@ from package import (
     SolutionJSON,
     ROOT,
     csv_wrap,
+    load_result_lines,
     prettify,
 )
 
@@ -28,6 +30,7 @@ def random_str(length: int) -> str:
 class Namespace(argparse.Namespace):
     problem: str
     url: Optional[str]
+    input: Optional[str]
 
 
 def read_solution() -> Optional[SolutionJSON]:
@@ -63,20 +66,7 @@ def read_solution() -> Optional[SolutionJSON]:
     }
 
 
-parser = argparse.ArgumentParser(
-    description="The min-timespan parallel technician-and-drone scheduling in door-to-door sampling service system.\nAlgorithm output transformer.",
-    formatter_class=argparse.ArgumentDefaultsHelpFormatter,
-)
-parser.add_argument("problem", type=str, help="the problem name in the archive")
-parser.add_argument("--url", type=str, required=False, help="the GitHub Actions job URL")
-
-
-if __name__ == "__main__":
-    working_dir = os.getcwd()
-
-    namespace = Namespace()
-    parser.parse_args(namespace=namespace)
-
+def read_stdin(problem: str, url: Optional[str]) -> ResultJSON[SolutionJSON]:
     iterations = int(input())
 
     tabu_size_factor = float(input())
@@ -96,8 +86,6 @@ if __name__ == "__main__":
     endurance_fixed_time = float(input())
     endurance_drone_speed = float(input())
 
-    problem = Problem.import_data(namespace.problem)
-
     solution = read_solution()
     assert solution is not None
 
@@ -125,8 +113,8 @@ if __name__ == "__main__":
     elapsed = float(input()) / 1000  # Convert ms to s
     strategy = input()
 
-    data: ResultJSON[SolutionJSON] = {
-        "problem": namespace.problem,
+    return {
+        "problem": problem,
         "trucks_count": len(solution["truck_paths"]),
         "drones_count": len(solution["drone_paths"]),
         "iterations": iterations,
@@ -153,9 +141,42 @@ if __name__ == "__main__":
         "last_improved": last_improved,
         "elite_set": elite_set,
         "elapsed": elapsed,
-        "url": namespace.url,
+        "url": url,
         "strategy": strategy,
     }
+
+
+parser = argparse.ArgumentParser(
+    description="The min-timespan parallel technician-and-drone scheduling in door-to-door sampling service system.\nAlgorithm output transformer.",
+    formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+)
+parser.add_argument("problem", type=str, help="the problem name in the archive")
+parser.add_argument("--url", type=str, required=False, help="the GitHub Actions job URL")
+parser.add_argument("--input", type=str, required=False, help="the JSON-lines result written by main.exe --output, instead of the text output from stdin")
+
+
+if __name__ == "__main__":
+    working_dir = os.getcwd()
+
+    namespace = Namespace()
+    parser.parse_args(namespace=namespace)
+
+    if namespace.input is not None:
+        data = load_result_lines(Path(namespace.input), url=namespace.url)
+        data["problem"] = namespace.problem
+    else:
+        data = read_stdin(namespace.problem, namespace.url)
+
+    problem = Problem.import_data(namespace.problem)
+
+    solution = data["solution"]
+    propagation = data["propagation"]
+    history = data["history"]
+    progress = data["progress"]
+    coefficients = data["coefficients"]
+    neighborhoods = data["neighborhoods"]
+    elite_set = data["elite_set"]
+
     print(solution)
 
     ROOT.joinpath("result").mkdir(parents=True, exist_ok=True)
@@ -1,6 +1,9 @@
 from __future__ import annotations
 
-from typing_extensions import Dict, Generic, List, Literal, Optional, Tuple, TypedDict, TypeVar, Union, overload
+import json
+import re
+from pathlib import Path
+from typing_extensions import Any, Dict, Generic, List, Literal, NotRequired, Optional, Tuple, TypedDict, TypeVar, Union, overload
 
 
 __all__ = (
@@ -8,9 +11,14 @@ __all__ = (
     "PrettySolutionJSON",
     "PropagationJSON",
     "NeighborhoodJSON",
+    "NeighborhoodStatisticsJSON",
+    "AnytimeJSON",
+    "AllocationsJSON",
     "ResultJSON",
     "MILPResultJSON",
-    "prettify"
+    "prettify",
+    "load_result_lines",
+    "load_milp_results",
 )
 
 
@@ -49,6 +57,38 @@ class NeighborhoodJSON(TypedDict):
     pair: Tuple[int, int]
 
 
+class NeighborhoodCountersJSON(TypedDict):
+    generated: int
+    pruned: int
+    evaluated: int
+    feasible: int
+    tabu_rejected: int
+    aspiration_hits: int
+    wins: int
+    improvement: float
+
+
+class NeighborhoodStatisticsJSON(TypedDict):
+    neighborhood: str
+    elapsed: float
+    total: NeighborhoodCountersJSON
+    pairs: Dict[Literal["truck-truck", "truck-drone", "drone-drone"], NeighborhoodCountersJSON]
+
+
+class AnytimeJSON(TypedDict):
+    elapsed: float
+    iteration: int
+    working_time: float
+
+
+class AllocationsJSON(TypedDict):
+    zone: str
+    activations: int
+    allocations: int
+    bytes: int
+    peak_bytes: int
+
+
 class ResultJSON(Generic[T], TypedDict):
     problem: str
     trucks_count: int
@@ -79,6 +119,9 @@ class ResultJSON(Generic[T], TypedDict):
     elapsed: float
     url: Optional[str]
     strategy: str
+    statistics: NotRequired[List[NeighborhoodStatisticsJSON]]
+    anytime: NotRequired[List[AnytimeJSON]]
+    allocations: NotRequired[List[AllocationsJSON]]
 
 
 class _FeasibleMILPResultJSON(TypedDict):
@@ -120,3 +163,74 @@ def prettify(solution: Optional[SolutionJSON]) -> Optional[PrettySolutionJSON]:
         "truck_paths": str(solution["truck_paths"]),
         "drone_paths": str(solution["drone_paths"]),
     }
+
+
+def load_result_lines(path: Path, /, *, url: Optional[str] = None) -> ResultJSON[SolutionJSON]:
+    """Load a result written by `build/main.exe --output` (JSON lines)"""
+    metadata: Dict[str, Any] = {}
+    solution: Optional[SolutionJSON] = None
+    propagation: List[PropagationJSON[SolutionJSON]] = []
+    history: List[Optional[SolutionJSON]] = []
+    progress: List[Optional[SolutionJSON]] = []
+    coefficients: List[List[float]] = []
+    neighborhoods: List[NeighborhoodJSON] = []
+    elite_set: List[List[float]] = []
+    statistics: List[NeighborhoodStatisticsJSON] = []
+    anytime: List[AnytimeJSON] = []
+    allocations: List[AllocationsJSON] = []
+
+    with path.open("r") as file:
+        for line in file:
+            data = json.loads(line)
+            kind = data.pop("type")
+            if kind == "metadata":
+                metadata = data
+            elif kind == "solution":
+                solution = data["solution"]
+            elif kind == "propagation":
+                propagation.append({"solution": data["solution"], "label": data["label"]})
+            elif kind == "iteration":
+                history.append(data["history"])
+                progress.append(data["progress"])
+                coefficients.append(data["coefficients"])
+                neighborhoods.append(data["neighborhood"])
+                elite_set.append(data["elite_set"])
+            elif kind == "statistics":
+                statistics.append(data)
+            elif kind == "anytime":
+                anytime.append(data)
+            elif kind == "allocations":
+                allocations.append(data)
+
+    if solution is None:
+        raise ValueError(f"No solution found in {path}")
+
+    propagation.reverse()  # Written from the final solution back to the initial one
+
+    return {
+        **metadata,  # type: ignore
+        "solution": solution,
+        "propagation": propagation,
+        "history": history,
+        "progress": progress,
+        "coefficients": coefficients,
+        "neighborhoods": neighborhoods,
+        "elite_set": elite_set,
+        "url": url,
+        "statistics": statistics,
+        "anytime": anytime,
+        "allocations": allocations,
+    }
+
+
+def load_milp_results(directory: Path, /) -> Dict[str, MILPResultJSON]:
+    """Load the MILP reference results in `directory`, keyed by problem name"""
+    result: Dict[str, MILPResultJSON] = {}
+    for file in directory.iterdir():
+        match = re.search(r"\d+\.\d+\.\d+", file.name)
+        if file.is_file() and file.name.endswith(".json") and match is not None:
+            problem = match.group()
+            with file.open("r") as f:
+                result[problem] = json.load(f)
+
+    return result
@@ -2,24 +2,15 @@ from __future__ import annotations
 
 import itertools
 import json
-import re
 import sqlite3
 from string import ascii_lowercase
 from typing_extensions import Dict, Iterable
 
-from package import MILPResultJSON, Problem, ResultJSON, SolutionJSON, ROOT, csv_wrap
+from package import MILPResultJSON, Problem, ResultJSON, SolutionJSON, ROOT, csv_wrap, load_milp_results, load_result_lines
 
 
 def compare() -> Dict[str, MILPResultJSON]:
-    result: Dict[str, MILPResultJSON] = {}
-    for file in ROOT.joinpath("problems", "milp").iterdir():
-        match = re.search(r"\d+\.\d+\.\d+", file.name)
-        if file.is_file() and file.name.endswith(".json") and match is not None:
-            problem = match.group()
-            with file.open("r") as f:
-                result[problem] = json.load(f)
-
-    return result
+    return load_milp_results(ROOT / "problems" / "milp")
 
 
 def result_reader() -> Iterable[ResultJSON[SolutionJSON]]:
@@ -31,6 +22,10 @@ def result_reader() -> Iterable[ResultJSON[SolutionJSON]]:
 
             yield data
 
+        elif file.is_file() and file.name.endswith(".jsonl"):
+            print(file.absolute())
+            yield load_result_lines(file)
+
 
 COLUMN_CHARS = set(ascii_lowercase + "_")
 
@@ -0,0 +1,269 @@
+#include <benchmark.hpp>
+#include <solutions.hpp>
+
+// Count every heap allocation for the allocs/op column. The operators are kept out of line so
+// that GCC does not report the malloc/free pairs as mismatched with new/delete.
+
+__attribute__((noinline)) void *operator new(std::size_t size)
+{
+    utils::allocation_count.fetch_add(1, std::memory_order_relaxed);
+    utils::allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+__attribute__((noinline)) void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+__attribute__((noinline)) void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete[](void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+std::string config_label(const d2d::Problem *problem)
+{
+    if (problem->linear != nullptr)
+    {
+        return "linear";
+    }
+    else if (problem->nonlinear != nullptr)
+    {
+        return "non-linear";
+    }
+
+    return problem->endurance->fixed_time == 1e9 ? "unlimited" : "endurance";
+}
+
+std::string usage(const char *program)
+{
+    return utils::format(
+        "usage: %s [--min-time SECONDS] [--filter NAME] [--perf] [main.exe options] problem\n"
+        "Microbenchmarks of the evaluation core on a problem instance.\n"
+        "With --perf, hardware counters (Linux perf_event_open) are also reported per operation.\n",
+        program);
+}
+
+template <typename ST>
+void scan(utils::Benchmark &benchmark, d2d::BaseNeighborhood<ST> &neighborhood, const std::shared_ptr<ST> &solution)
+{
+    const auto reject = [](const std::shared_ptr<ST> &)
+    {
+        return false;
+    };
+
+    // Single scans, as in post-optimization, leave the tabu list and the win counters untouched
+    d2d::ScanPolicy intra_route_policy, inter_route_policy;
+    intra_route_policy.scope = d2d::ScanPolicy::INTRA_ROUTE;
+    inter_route_policy.scope = d2d::ScanPolicy::INTER_ROUTE;
+
+    benchmark.run(
+        "Scan " + neighborhood.label(),
+        [&]() -> std::size_t
+        {
+            auto generated = neighborhood.statistics().total().generated;
+            utils::do_not_optimize(neighborhood.move(solution, reject, intra_route_policy));
+            utils::do_not_optimize(neighborhood.move(solution, reject, inter_route_policy));
+            return neighborhood.statistics().total().generated - generated;
+        });
+}
+
+int main(int argc, char **argv)
+{
+    double min_time = 0.5;
+    std::string filter;
+    bool hardware_counters = false;
+
+    if (argc == 1)
+    {
+        std::cerr << usage(argv[0]);
+        return 1;
+    }
+
+    d2d::Problem *problem;
+    try
+    {
+        // Benchmark options are removed, the remaining arguments are passed to `Problem::load`
+        std::vector<const char *> arguments = {argv[0]};
+        for (int i = 1; i < argc; i++)
+        {
+            std::string argument = argv[i];
+            if (argument == "--min-time" && i + 1 < argc)
+            {
+                min_time = utils::parse_number<double>(argv[++i]);
+                if (!(min_time > 0) || std::isinf(min_time))
+                {
+                    throw std::invalid_argument(utils::format("--min-time must be a positive number of seconds, got %lf", min_time));
+                }
+            }
+            else if (argument == "--filter" && i + 1 < argc)
+            {
+                filter = argv[++i];
+            }
+            else if (argument == "--perf")
+            {
+                hardware_counters = true;
+            }
+            else
+            {
+                arguments.push_back(argv[i]);
+            }
+        }
+
+        problem = d2d::Problem::load(arguments.size(), arguments.data());
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << usage(argv[0]) << argv[0] << ": error: " << e.what() << std::endl;
+        return 2;
+    }
+
+    auto solution = d2d::initial_impl<d2d::Solution, 1>();
+
+    std::cout << "Problem " << problem->name << " with " << problem->customers.size() - 1 << " customers, "
+              << problem->trucks_count << " trucks, " << problem->drones_count << " drones, "
+              << config_label(problem) << " drone energy model" << std::endl;
+
+    utils::Benchmark benchmark(min_time, filter, hardware_counters);
+    auto parent = std::make_shared<d2d::ParentInfo<d2d::Solution>>(nullptr, "benchmark");
+
+    benchmark.run(
+        "Solution::Solution",
+        [&]()
+        {
+            d2d::Solution s(solution->truck_routes(), solution->drone_routes(), parent);
+            utils::do_not_optimize(s.working_time);
+        });
+
+    benchmark.run(
+        "TruckRoute::calculate_time_segments",
+        [&]() -> std::size_t
+        {
+            std::size_t routes = 0;
+            for (auto &vehicle_routes : solution->truck_routes())
+            {
+                std::size_t coefficients_index = 0;
+                double current_within_timespan = 0;
+                for (auto &route : vehicle_routes)
+                {
+                    utils::do_not_optimize(d2d::TruckRoute::calculate_time_segments(route.customers(), coefficients_index, current_within_timespan));
+                    routes++;
+                }
+            }
+
+            return routes;
+        });
+
+    // Synthetic drone routes of 3 dronable customers each, so that the case does not depend on the
+    // initial solution
+    std::vector<std::vector<std::size_t>> drone_routes;
+    std::vector<std::size_t> dronable;
+    for (std::size_t i = 1; i < problem->customers.size(); i++)
+    {
+        if (problem->columns.dronable[i])
+        {
+            dronable.push_back(i);
+        }
+    }
+    for (std::size_t i = 0; i + 3 <= dronable.size(); i += 3)
+    {
+        drone_routes.push_back({0, dronable[i], dronable[i + 1], dronable[i + 2], 0});
+    }
+
+    if (!drone_routes.empty())
+    {
+        benchmark.run(
+            "DroneRoute(" + config_label(problem) + ")",
+            [&]() -> std::size_t
+            {
+                for (auto &customers : drone_routes)
+                {
+                    d2d::DroneRoute route(customers);
+                    utils::do_not_optimize(route.energy_consumption());
+                }
+
+                return drone_routes.size();
+            });
+    }
+
+    std::vector<std::shared_ptr<d2d::BaseNeighborhood<d2d::Solution>>> neighborhoods = {
+        std::make_shared<d2d::MoveXY<d2d::Solution, 1, 0>>(),
+        std::make_shared<d2d::MoveXY<d2d::Solution, 1, 1>>(),
+        std::make_shared<d2d::MoveXY<d2d::Solution, 2, 0>>(),
+        std::make_shared<d2d::MoveXY<d2d::Solution, 2, 1>>(),
+        std::make_shared<d2d::MoveXY<d2d::Solution, 2, 2>>(),
+        std::make_shared<d2d::TwoOpt<d2d::Solution>>(),
+        std::make_shared<d2d::CrossExchange<d2d::Solution>>(),
+        std::make_shared<d2d::CrossExchange_3<d2d::Solution>>(),
+        std::make_shared<d2d::EjectionChain<d2d::Solution>>(),
+    };
+    for (auto &neighborhood : neighborhoods)
+    {
+        scan(benchmark, *neighborhood, solution);
+    }
+
+    const auto distance = [&problem](const std::size_t &i, const std::size_t &j)
+    {
+        return problem->distances[i][j];
+    };
+
+    for (std::size_t n : {4, 8, 12, 16})
+    {
+        if (n <= problem->customers.size())
+        {
+            benchmark.run(
+                utils::format("held_karp_algorithm(n=%lu)", n),
+                [&]()
+                { utils::do_not_optimize(utils::held_karp_algorithm(n, distance)); });
+        }
+    }
+
+    for (std::size_t n : {10, 50, 100, 200})
+    {
+        if (n <= problem->customers.size())
+        {
+            benchmark.run(
+                utils::format("two_opt_heuristic(n=%lu)", n),
+                [&]()
+                { utils::do_not_optimize(utils::two_opt_heuristic(n, distance)); });
+        }
+    }
+
+    std::vector<std::size_t> customers(problem->customers.size() - 1);
+    std::iota(customers.begin(), customers.end(), 1);
+    auto k = std::max<std::size_t>(problem->trucks_count, 1);
+
+    benchmark.run(
+        utils::format("clusterize_1(k=%lu)", k),
+        [&]()
+        { utils::do_not_optimize(d2d::clusterize_1(customers, k)); });
+
+    benchmark.run(
+        utils::format("clusterize_2(k=%lu)", k),
+        [&]()
+        { utils::do_not_optimize(d2d::clusterize_2(customers, k)); });
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include <instance.hpp>
+
+int main(int argc, char **argv)
+{
+    std::vector<std::string> arguments;
+    bool with_distances = true, matrix = false;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if (argument == "--no-distances")
+        {
+            with_distances = false;
+        }
+        else if (argument == "--matrix")
+        {
+            matrix = true;
+        }
+        else
+        {
+            arguments.push_back(argument);
+        }
+    }
+
+    if (arguments.size() != 2)
+    {
+        std::cerr << "usage: " << argv[0] << " [--no-distances | --matrix] input output" << std::endl;
+        std::cerr << "Convert a problem data file (text or binary) to the binary instance format." << std::endl;
+        std::cerr << "With --matrix, convert a square matrix (e.g. truck road distances) to the binary matrix format instead." << std::endl;
+        return 1;
+    }
+
+    utils::PerformanceBenchmark benchmark("Elapsed");
+
+    if (matrix)
+    {
+        auto data = d2d::InstanceData::read_matrix(arguments[0]);
+        d2d::InstanceData::write_matrix(arguments[1], data);
+
+        std::cerr << "Wrote " << data.size() << "x" << data.size() << " matrix to " << arguments[1] << std::endl;
+    }
+    else
+    {
+        auto instance = d2d::InstanceData::read(arguments[0]);
+        instance.write_binary(arguments[1], with_distances);
+
+        std::cerr << "Wrote " << instance.customers_count() << " customers to " << arguments[1] << std::endl;
+    }
+
+    return 0;
+}
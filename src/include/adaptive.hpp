@@ -0,0 +1,82 @@
+#pragma once
+
+#include "random.hpp"
+
+namespace utils
+{
+    /**
+     * @brief Adaptive roulette-wheel selection among a fixed number of operators, as in adaptive
+     * large neighborhood search, rewarding each operator by its gain per second of running time.
+     *
+     * The gains and running times of all operators decay exponentially at each update, so that the
+     * selection follows the current stage of the search. An operator is selected with probability
+     * proportional to its gain rate, mixed with a uniform exploration probability so that
+     * operators without recent gains are still tried.
+     */
+    class AdaptiveRoulette
+    {
+    private:
+        std::vector<double> _gains, _times;
+        const double _decay, _exploration;
+
+    public:
+        /**
+         * @brief Construct a new AdaptiveRoulette object
+         *
+         * @param size The number of operators
+         * @param decay The factor applied to all gains and running times at each update
+         * @param exploration The probability of selecting an operator uniformly at random
+         */
+        AdaptiveRoulette(const std::size_t &size, const double &decay = 0.99, const double &exploration = 0.1)
+            : _gains(size), _times(size), _decay(decay), _exploration(exploration)
+        {
+            if (size == 0)
+            {
+                throw std::invalid_argument("Cannot select among 0 operators");
+            }
+        }
+
+        /** @brief The decayed gain per second of an operator, 0 if it has not run recently */
+        double rate(const std::size_t &index) const
+        {
+            return _times[index] > 0 ? _gains[index] / _times[index] : 0;
+        }
+
+        /** @brief Select an operator */
+        std::size_t select() const
+        {
+            std::vector<double> weights(_gains.size());
+            for (std::size_t i = 0; i < weights.size(); i++)
+            {
+                weights[i] = rate(i);
+            }
+
+            if (random(0.0, 1.0) < _exploration || std::all_of(weights.begin(), weights.end(), [](const double &w)
+                                                                { return w <= 0; }))
+            {
+                return random<std::size_t>(0, weights.size() - 1);
+            }
+
+            return weighted_random(weights)[0];
+        }
+
+        /**
+         * @brief Record a run of an operator
+         *
+         * @param index The operator
+         * @param gain The cost decrease achieved by this run, negative values are counted as 0
+         * @param time The running time in seconds
+         */
+        void update(const std::size_t &index, const double &gain, const double &time)
+        {
+            for (std::size_t i = 0; i < _gains.size(); i++)
+            {
+                _gains[i] *= _decay;
+                _times[i] *= _decay;
+            }
+
+            _gains[index] += std::max(gain, 0.0);
+            _times[index] += time;
+        }
+    };
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "format.hpp"
+
+#if defined(TRACK_ALLOCATIONS)
+#include <malloc.h>
+#endif
+
+namespace utils
+{
+    /**
+     * @brief Heap allocation counters, attributed to the innermost instrumentation zone of the
+     * allocating thread (see `InstrumentZone`).
+     *
+     * Tracking requires building with `-D TRACK_ALLOCATIONS`, which replaces the global
+     * `operator new` and `operator delete` of `main.exe` to call `allocate` and `deallocate`.
+     * Otherwise, every function is a no-op and all counters stay at 0.
+     */
+    class AllocationTracker
+    {
+    public:
+        struct Counters
+        {
+            /** @brief Number of allocations made while the zone was the innermost one */
+            std::uint64_t allocations = 0;
+
+            /** @brief Number of bytes requested by these allocations */
+            std::uint64_t bytes = 0;
+
+            /**
+             * @brief Maximum increase of live heap bytes during a single activation of the zone,
+             * including nested zones
+             */
+            std::int64_t peak_bytes = 0;
+
+            /** @brief Number of times the zone was entered */
+            std::uint64_t activations = 0;
+        };
+
+#if defined(TRACK_ALLOCATIONS)
+        static constexpr bool enabled = true;
+#else
+        static constexpr bool enabled = false;
+#endif
+
+    private:
+        struct _Frame
+        {
+            const std::string *name;
+            std::uint64_t allocations, bytes;
+            std::int64_t live, peak;
+        };
+
+        static constexpr std::size_t MAX_DEPTH = 32;
+
+        // Plain thread-local storage, so that tracking never allocates itself
+        static inline thread_local _Frame _frames[MAX_DEPTH];
+        static inline thread_local std::size_t _depth = 0;
+        static inline thread_local bool _bookkeeping = false;
+
+        static inline std::atomic<std::uint64_t> _allocations = 0, _bytes = 0;
+        static inline std::atomic<std::int64_t> _live = 0, _peak = 0;
+
+        static inline std::mutex _mutex;
+        static inline std::vector<std::pair<std::string, Counters>> _zones;
+
+        static std::size_t _usable_size(void *ptr)
+        {
+#if !defined(TRACK_ALLOCATIONS)
+            return 0;
+#elif defined(WIN32)
+            return _msize(ptr);
+#else
+            return malloc_usable_size(ptr);
+#endif
+        }
+
+        static void _update_live(const std::int64_t &delta)
+        {
+            auto live = _live.fetch_add(delta, std::memory_order_relaxed) + delta;
+            auto peak = _peak.load(std::memory_order_relaxed);
+            while (live > peak && !_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+            {
+            }
+
+            if (!_bookkeeping)
+            {
+                for (std::size_t i = 0; i < std::min(_depth, MAX_DEPTH); i++)
+                {
+                    _frames[i].live += delta;
+                    _frames[i].peak = std::max(_frames[i].peak, _frames[i].live);
+                }
+            }
+        }
+
+    public:
+        /** @brief Record an allocation of `size` bytes at `ptr` */
+        static void allocate(void *ptr, const std::size_t &size)
+        {
+            _allocations.fetch_add(1, std::memory_order_relaxed);
+            _bytes.fetch_add(size, std::memory_order_relaxed);
+            if (!_bookkeeping && _depth > 0 && _depth <= MAX_DEPTH)
+            {
+                _frames[_depth - 1].allocations++;
+                _frames[_depth - 1].bytes += size;
+            }
+
+            _update_live(_usable_size(ptr));
+        }
+
+        /** @brief Record the deallocation of `ptr` */
+        static void deallocate(void *ptr)
+        {
+            if (ptr != nullptr)
+            {
+                _update_live(-static_cast<std::int64_t>(_usable_size(ptr)));
+            }
+        }
+
+        /** @brief Enter a zone on the calling thread. `name` must outlive the matching `pop` */
+        static void push(const std::string &name)
+        {
+            if constexpr (enabled)
+            {
+                if (_depth < MAX_DEPTH)
+                {
+                    _frames[_depth] = {&name, 0, 0, 0, 0};
+                }
+                _depth++;
+            }
+        }
+
+        /** @brief Leave the innermost zone of the calling thread and accumulate its counters */
+        static void pop()
+        {
+            if constexpr (enabled)
+            {
+                _depth--;
+                if (_depth >= MAX_DEPTH)
+                {
+                    return;
+                }
+
+                auto frame = _frames[_depth];
+
+                _bookkeeping = true;
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    auto iter = std::find_if(
+                        _zones.begin(), _zones.end(),
+                        [&frame](const std::pair<std::string, Counters> &p)
+                        { return p.first == *frame.name; });
+                    if (iter == _zones.end())
+                    {
+                        _zones.emplace_back(*frame.name, Counters());
+                        iter = _zones.end() - 1;
+                    }
+
+                    iter->second.allocations += frame.allocations;
+                    iter->second.bytes += frame.bytes;
+                    iter->second.peak_bytes = std::max(iter->second.peak_bytes, frame.peak);
+                    iter->second.activations++;
+                }
+                _bookkeeping = false;
+            }
+        }
+
+        /** @brief The counters of all zones so far, in order of first completion */
+        static std::vector<std::pair<std::string, Counters>> zones()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _zones;
+        }
+
+        /** @brief The counters of the whole process, with the peak of live heap bytes */
+        static Counters total()
+        {
+            Counters result;
+            result.allocations = _allocations.load(std::memory_order_relaxed);
+            result.bytes = _bytes.load(std::memory_order_relaxed);
+            result.peak_bytes = _peak.load(std::memory_order_relaxed);
+            result.activations = 1;
+            return result;
+        }
+    };
+}
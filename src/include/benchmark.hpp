@@ -0,0 +1,172 @@
+#pragma once
+
+#include "perf_counters.hpp"
+#include "utils.hpp"
+
+namespace utils
+{
+    /**
+     * @brief Number of heap allocations and allocated bytes since the program started.
+     *
+     * These are only updated by executables that replace the global `operator new` to increment
+     * them (see `src/bench.cpp`), and stay at 0 otherwise.
+     */
+    inline std::atomic<std::uint64_t> allocation_count = 0, allocation_bytes = 0;
+
+    /** @brief Prevent the compiler from optimizing away the computation of `value` */
+    template <typename T>
+    void do_not_optimize(const T &value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /**
+     * @brief A minimal microbenchmark runner.
+     *
+     * Each case is repeated in batches of doubling size until a batch runs for at least the
+     * minimum time, then the last batch is reported as time per operation, heap allocations per
+     * operation and throughput, optionally with hardware counters per operation.
+     */
+    class Benchmark
+    {
+    private:
+        const double _min_time;
+        const std::string _filter;
+        std::unique_ptr<PerfCounters> _counters;
+
+    public:
+        /**
+         * @brief Construct a new Benchmark object.
+         *
+         * @param min_time The minimum duration of the measured batch, in seconds
+         * @param filter Only run cases whose name contains this string
+         * @param hardware_counters Whether to also report hardware counters, see `PerfCounters`. If
+         * they cannot be opened, a warning is printed and only wall time is reported.
+         */
+        Benchmark(const double &min_time, const std::string &filter, const bool hardware_counters = false)
+            : _min_time(min_time), _filter(filter)
+        {
+            if (hardware_counters)
+            {
+                try
+                {
+                    _counters = std::make_unique<PerfCounters>();
+                }
+                catch (std::runtime_error &e)
+                {
+                    std::cerr << "Hardware counters are unavailable (" << e.what() << ")" << std::endl;
+                }
+            }
+
+            std::cout << utils::format(
+                "%-48s %12s %14s %12s %14s %14s %14s",
+                "Case", "Iterations", "ns/op", "allocs/op", "bytes/op", "ops/s", "items/s");
+            if (_counters != nullptr)
+            {
+                for (auto &event : PerfCounters::EVENTS)
+                {
+                    std::cout << utils::format(" %16s", (std::string(event.name) + "/op").c_str());
+                }
+                std::cout << utils::format(" %6s", "IPC");
+            }
+            std::cout << std::endl;
+        }
+
+        bool selected(const std::string &name) const
+        {
+            return name.find(_filter) != std::string::npos;
+        }
+
+        /**
+         * @brief Measure a case.
+         *
+         * @param name The case name
+         * @param operation The measured operation. If it returns a `std::size_t`, this is the number of
+         * items (e.g. candidate solutions) processed by one call and is reported as items/s.
+         */
+        template <typename _Operation>
+        void run(const std::string &name, const _Operation &operation)
+        {
+            if (!selected(name))
+            {
+                return;
+            }
+
+            using clock = std::chrono::steady_clock;
+            constexpr bool counts_items = std::is_same_v<std::invoke_result_t<const _Operation &>, std::size_t>;
+
+            // Warm up caches and lazily initialized state
+            if constexpr (counts_items)
+            {
+                do_not_optimize(operation());
+            }
+            else
+            {
+                operation();
+            }
+
+            std::size_t iterations = 1;
+            while (true)
+            {
+                std::size_t items = 0;
+                auto allocations = allocation_count.load(std::memory_order_relaxed);
+                auto bytes = allocation_bytes.load(std::memory_order_relaxed);
+                if (_counters != nullptr)
+                {
+                    _counters->start();
+                }
+                auto start = clock::now();
+
+                for (std::size_t i = 0; i < iterations; i++)
+                {
+                    if constexpr (counts_items)
+                    {
+                        items += operation();
+                    }
+                    else
+                    {
+                        operation();
+                    }
+                }
+
+                double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+                PerfCounters::values_t values;
+                if (_counters != nullptr)
+                {
+                    values = _counters->stop();
+                }
+                if (elapsed >= _min_time || iterations >= (std::size_t(1) << 40))
+                {
+                    allocations = allocation_count.load(std::memory_order_relaxed) - allocations;
+                    bytes = allocation_bytes.load(std::memory_order_relaxed) - bytes;
+
+                    std::cout << utils::format(
+                        "%-48s %12lu %14.1lf %12.1lf %14.1lf %14.1lf %14s",
+                        name.c_str(),
+                        iterations,
+                        1e9 * elapsed / iterations,
+                        static_cast<double>(allocations) / iterations,
+                        static_cast<double>(bytes) / iterations,
+                        iterations / elapsed,
+                        counts_items ? utils::format("%.1lf", items / elapsed).c_str() : "-");
+                    if (_counters != nullptr)
+                    {
+                        for (auto &value : values)
+                        {
+                            std::cout << utils::format(" %16s", value.has_value() ? utils::format("%.1lf", *value / iterations).c_str() : "-");
+                        }
+
+                        // Indices of cycles and instructions in `PerfCounters::EVENTS`
+                        std::cout << utils::format(
+                            " %6s",
+                            values[0].has_value() && values[1].has_value() && *values[0] > 0 ? utils::format("%.2lf", *values[1] / *values[0]).c_str() : "-");
+                    }
+                    std::cout << std::endl;
+                    return;
+                }
+
+                iterations *= 2;
+            }
+        }
+    };
+}
@@ -35,6 +35,12 @@ namespace d2d
         {
             return _maximum_velocity;
         }
+
+        /** @brief The highest speed over all time-of-day coefficients */
+        double top_speed() const
+        {
+            return _maximum_velocity * *std::max_element(_coefficients.begin(), _coefficients.end());
+        }
     };
 
     enum StatsType
@@ -11,10 +11,9 @@ namespace d2d
         const std::vector<std::vector<TruckRoute>> &truck_routes,
         const std::vector<std::vector<DroneRoute>> &drone_routes)
     {
-        auto temp = std::make_shared<ST>(truck_routes, drone_routes, nullptr, false);
+        auto temp = ST::create(truck_routes, drone_routes, nullptr, false);
         if (!temp->feasible)
         {
-            // std::cerr << "Insertion would violate " << temp->drone_energy_violation << " " << temp->capacity_violation << " " << temp->waiting_time_violation << " " << temp->fixed_time_violation << std::endl;
             return false;
         }
 
@@ -87,7 +86,7 @@ namespace d2d
                         // Temporary modify
                         truck_routes_modified[truck][route] = TruckRoute(r);
 
-                        auto new_temp = std::make_shared<ST>(truck_routes_modified, drone_routes, nullptr, false);
+                        auto new_temp = ST::create(truck_routes_modified, drone_routes, nullptr, false);
                         if (temp == nullptr || new_temp->working_time < temp->working_time || (new_temp->feasible && !temp->feasible))
                         {
                             temp = new_temp;
@@ -101,7 +100,7 @@ namespace d2d
                 // Temporary append
                 truck_routes_modified[truck].emplace_back(std::vector<std::size_t>{0, customer, 0});
 
-                auto new_temp = std::make_shared<ST>(truck_routes_modified, drone_routes, nullptr, false);
+                auto new_temp = ST::create(truck_routes_modified, drone_routes, nullptr, false);
                 if (temp == nullptr || new_temp->working_time < temp->working_time || (new_temp->feasible && !temp->feasible))
                 {
                     temp = new_temp;
@@ -111,7 +110,7 @@ namespace d2d
                 truck_routes_modified[truck].pop_back();
             }
 
-            truck_routes = temp->truck_routes;
+            truck_routes = temp->truck_routes();
         }
     }
 
@@ -226,8 +225,6 @@ namespace d2d
             for (std::size_t i = 0; i < angles.size(); i++)
             {
                 double diff = angle_diff(angles[(i + angles.size() - 1) % angles.size()], angles[i]);
-                // std::cerr << "Angle of " << ordered[i] << " = " << angles[i] * 180 / M_PI << std::endl;
-                // std::cerr << "Angle from " << ordered[(i + angles.size() - 1) % angles.size()] << " to " << ordered[i] << " = " << diff * 180 / M_PI << std::endl;
                 if (diff < 0)
                 {
                     diff += 2 * M_PI;
@@ -242,7 +239,6 @@ namespace d2d
 
             std::rotate(ordered.begin(), ordered.begin() + shift, ordered.end());
             std::rotate(angles.begin(), angles.begin() + shift, angles.end());
-            // std::cerr << "Shifted to customer " << shift << " where max_diff = " << max_diff << std::endl;
         }
 
         {
@@ -265,14 +261,13 @@ namespace d2d
         return clusters;
     }
 
-    void _sort_cluster_with_starting_point(std::vector<std::size_t> &cluster, const std::size_t &start)
+    void _sort_cluster_with_starting_point(std::vector<std::size_t> &cluster, const std::size_t &start, const utils::SquareMatrix<double> &distances)
     {
-        auto problem = Problem::get_instance();
         cluster.insert(cluster.begin(), start); // So that nearest_heuristic can start from starting point
 
-        const auto distance = [&problem, &cluster](const std::size_t &i, const std::size_t &j)
+        const auto distance = [&distances, &cluster](const std::size_t &i, const std::size_t &j)
         {
-            return problem->distances[cluster[i]][cluster[j]];
+            return distances[cluster[i]][cluster[j]];
         };
 
         auto [_, order] = cluster.size() < 20
@@ -337,7 +332,6 @@ namespace d2d
             clusters = clusterize_2(index, problem->trucks_count);
         }
 
-        // std::cerr << clusters << std::endl;
         std::vector<std::vector<TruckRoute>> truck_routes(problem->trucks_count);
         std::vector<std::vector<DroneRoute>> drone_routes(problem->trucks_count); // Will resize to problem->drones_count later
 
@@ -366,7 +360,6 @@ namespace d2d
                 }
             }
         }
-        // std::cerr << "real_truckable = " << std::accumulate(real_truckable.begin(), real_truckable.end(), 0) << std::endl;
 
         // Filter out dronable customers who cannot form a single feasible route
         std::vector<bool> real_dronable(problem->customers.size());
@@ -376,7 +369,7 @@ namespace d2d
             std::vector<std::vector<d2d::TruckRoute>> truck_routes(problem->trucks_count);
             for (std::size_t i = 1; i < problem->customers.size(); i++)
             {
-                if (problem->customers[i].dronable)
+                if (problem->columns.dronable[i])
                 {
                     std::vector<std::vector<DroneRoute>> drone_routes(problem->drones_count);
                     drone_routes[0].emplace_back(std::vector<std::size_t>{0, i, 0});
@@ -387,7 +380,6 @@ namespace d2d
                 }
             }
         }
-        // std::cerr << "real_dronable = " << std::accumulate(real_dronable.begin(), real_dronable.end(), 0) << std::endl;
 
         const auto truckable = [&real_truckable](std::size_t c)
         {
@@ -410,14 +402,12 @@ namespace d2d
         std::multiset<_initialization_iteration_pack> timestamps;
         for (std::size_t i = 0; i < clusters.size(); i++)
         {
-            // std::cerr << "At cluster " << i << ": " << clusters[i] << std::endl;
             if (clusters[i].empty())
             {
                 continue;
             }
 
             std::shuffle(clusters[i].begin(), clusters[i].end(), utils::rng);
-            // std::cerr << "Shuffled to " << clusters[i] << std::endl;
 
             auto truckable_iter = std::find_if(clusters[i].begin(), clusters[i].end(), truckable);
             if (truckable_iter != clusters[i].end())
@@ -428,7 +418,6 @@ namespace d2d
             std::sort(
                 clusters[i].begin(), clusters[i].end(), [&problem](const std::size_t &i, const std::size_t &j)
                 { return problem->distances[0][i] < problem->distances[0][j]; });
-            // std::cerr << "Sorted to " << clusters[i] << std::endl;
 
             auto dronable_iter = std::find_if(clusters[i].begin(), clusters[i].end(), dronable);
             if (dronable_iter != clusters[i].end())
@@ -449,9 +438,9 @@ namespace d2d
             double min_distance = std::numeric_limits<double>::max();
             for (auto &customer : clusters[clusters_mapping[from]])
             {
-                if (truckable(customer) && problem->distances[from][customer] < min_distance)
+                if (truckable(customer) && problem->truck_distance(from, customer) < min_distance)
                 {
-                    min_distance = problem->distances[from][customer];
+                    min_distance = problem->truck_distance(from, customer);
                     nearest = customer;
                 }
             }
@@ -460,9 +449,9 @@ namespace d2d
             {
                 for (auto &customer : global_customers)
                 {
-                    if (truckable(customer) && problem->distances[from][customer] < min_distance)
+                    if (truckable(customer) && problem->truck_distance(from, customer) < min_distance)
                     {
-                        min_distance = problem->distances[from][customer];
+                        min_distance = problem->truck_distance(from, customer);
                         nearest = customer;
                     }
                 }
@@ -470,8 +459,8 @@ namespace d2d
 
             if (nearest < std::numeric_limits<std::size_t>::max())
             {
-                auto temp = std::make_shared<ST>(truck_routes, drone_routes, nullptr, false);
-                timestamps.emplace(temp->truck_working_time[truck], truck, from, nearest, true);
+                auto temp = ST::create(truck_routes, drone_routes, nullptr, false);
+                timestamps.emplace(temp->truck_working_time()[truck], truck, from, nearest, true);
             }
         };
 
@@ -502,15 +491,13 @@ namespace d2d
 
             if (nearest < std::numeric_limits<std::size_t>::max())
             {
-                auto temp = std::make_shared<ST>(truck_routes, drone_routes, nullptr, false);
-                timestamps.emplace(temp->drone_working_time[drone], drone, from, nearest, false);
+                auto temp = ST::create(truck_routes, drone_routes, nullptr, false);
+                timestamps.emplace(temp->drone_working_time()[drone], drone, from, nearest, false);
             }
         };
 
         while (!global_customers.empty())
         {
-            // std::cerr << "\e[31mtimestamps = " << timestamps << "\e[0m" << std::endl;
-            // std::cerr << "global = " << global_customers << std::endl;
             const _initialization_iteration_pack packed(*timestamps.begin());
             timestamps.erase(timestamps.begin());
 
@@ -538,12 +525,10 @@ namespace d2d
                 bool insertable;
                 if (truck_routes[packed.vehicle].empty() || packed.before == 0)
                 {
-                    // std::cerr << "Constructing new route for truck " << packed.vehicle << " with customer " << packed.customer << std::endl;
                     insertable = _try_insert<ST>(truck_routes[packed.vehicle], packed.customer, truck_routes, drone_routes);
                 }
                 else
                 {
-                    // std::cerr << "Inserting to truck route " << truck_routes[packed.vehicle].back() << " with customer " << packed.customer << std::endl;
                     insertable = _try_insert<ST>(truck_routes[packed.vehicle].back(), packed.customer, truck_routes, drone_routes);
                 }
 
@@ -563,10 +548,8 @@ namespace d2d
                         pool.erase(p.customer);
                     }
 
-                    // std::cerr << "pool = " << pool << ", timestamps = " << timestamps << std::endl;
                     if (pool.empty())
                     {
-                        // std::cerr << "Utilizing global_customers" << std::endl;
                         std::copy_if(
                             global_customers.begin(), global_customers.end(),
                             std::inserter(pool, pool.begin()),
@@ -579,15 +562,13 @@ namespace d2d
 
                     if (pool.empty())
                     {
-                        // std::cerr << "\e[31mPool is empty!\e[0m" << std::endl;
                         continue;
                     }
 
                     auto next_customer = *std::max_element(
                         pool.begin(), pool.end(), [&problem](const std::size_t &i, const std::size_t &j)
-                        { return problem->distances[0][i] < problem->distances[0][j]; });
+                        { return problem->truck_distance(0, i) < problem->truck_distance(0, j); });
 
-                    // std::cerr << "next_customer = " << next_customer << std::endl;
                     timestamps.emplace(packed.working_time, packed.vehicle, 0, next_customer, true);
                 }
                 else
@@ -601,12 +582,10 @@ namespace d2d
                 bool insertable;
                 if (drone_routes[packed.vehicle].empty() || packed.before == 0)
                 {
-                    // std::cerr << "Constructing new route for drone " << packed.vehicle << " with customer " << packed.customer << std::endl;
                     insertable = _try_insert<ST>(drone_routes[packed.vehicle], packed.customer, truck_routes, drone_routes);
                 }
                 else
                 {
-                    // std::cerr << "Inserting to drone route " << drone_routes[packed.vehicle].back() << " with customer " << packed.customer << std::endl;
                     insertable = _try_insert<ST>(drone_routes[packed.vehicle].back(), packed.customer, truck_routes, drone_routes);
                 }
 
@@ -626,10 +605,8 @@ namespace d2d
                         pool.erase(p.customer);
                     }
 
-                    // std::cerr << "pool = " << pool << ", timestamps = " << timestamps << std::endl;
                     if (pool.empty())
                     {
-                        // std::cerr << "Utilizing global_customers" << std::endl;
                         std::copy_if(
                             global_customers.begin(), global_customers.end(),
                             std::inserter(pool, pool.begin()),
@@ -642,7 +619,6 @@ namespace d2d
 
                     if (pool.empty())
                     {
-                        // std::cerr << "\e[31mPool is empty!\e[0m" << std::endl;
                         continue;
                     }
 
@@ -658,11 +634,6 @@ namespace d2d
                     drone_next(packed.customer, packed.vehicle);
                 }
             }
-
-            auto temp = std::make_shared<ST>(truck_routes, drone_routes, nullptr, false);
-            // std::cerr << "truck_routes = " << truck_routes << " \e[31m" << temp->truck_working_time << "\e[0m" << std::endl;
-            // std::cerr << "drone_routes = " << drone_routes << " \e[31m" << temp->drone_working_time << "\e[0m" << std::endl;
-            // std::cerr << "feasible = " << temp->feasible << " " << temp->drone_energy_violation << " " << temp->capacity_violation << " " << temp->waiting_time_violation << " " << temp->fixed_time_violation << std::endl;
         }
 
         // Resize drone routes to `problem->drones_count`
@@ -685,11 +656,14 @@ namespace d2d
             std::vector<std::pair<double, std::vector<d2d::DroneRoute *>>> _temp(problem->drones_count);
             std::vector<bool> _inserted(all_routes.size());
 
+            // The exhaustive search is cut off after 10 seconds, or a small share of the time limit
+            const double _reorder_limit = problem->time_limit > 0 ? std::min(10.0, 0.05 * problem->time_limit) : 10.0;
+
             auto _benchmark = std::make_unique<utils::PerformanceBenchmark>("Reorder drone routes");
             std::function<void(const std::size_t &, const std::size_t &)> _try;
             _try = [&](const std::size_t &drone, const std::size_t &inserted_count)
             {
-                if (_benchmark->elapsed<std::chrono::seconds>().count() >= 10)
+                if (_benchmark->elapsed<std::chrono::duration<double>>().count() >= _reorder_limit || problem->search_stopped())
                 {
                     return;
                 }
@@ -721,7 +695,6 @@ namespace d2d
                                 if (cost_cmp < _optimal)
                                 {
                                     _optimal = cost;
-                                    // std::cerr << "_optimal = " << _optimal << std::endl;
                                     for (std::size_t drone = 0; drone < problem->drones_count; drone++)
                                     {
                                         drone_routes[drone].clear();
@@ -764,7 +737,8 @@ namespace d2d
                 customers.pop_back();
                 customers.erase(customers.begin());
 
-                _sort_cluster_with_starting_point(customers, 0);
+                // Only the order matters here, so `truck_distance_scale` need not be applied
+                _sort_cluster_with_starting_point(customers, 0, problem->truck_distances);
                 customers.insert(customers.begin(), 0);
                 customers.push_back(0);
 
@@ -780,7 +754,7 @@ namespace d2d
                 customers.pop_back();
                 customers.erase(customers.begin());
 
-                _sort_cluster_with_starting_point(customers, 0);
+                _sort_cluster_with_starting_point(customers, 0, problem->distances);
                 customers.insert(customers.begin(), 0);
                 customers.push_back(0);
 
@@ -788,7 +762,7 @@ namespace d2d
             }
         }
 
-        return std::make_shared<ST>(
+        return ST::create(
             truck_routes_modified,
             drone_routes_modified,
             std::make_shared<ParentInfo<ST>>(nullptr, utils::format("initial-%d", _Clusterizer)));
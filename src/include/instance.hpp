@@ -0,0 +1,496 @@
+#pragma once
+
+#include "format.hpp"
+#include "matrix.hpp"
+#include "utils.hpp"
+
+namespace d2d
+{
+    /**
+     * @brief The geography of a problem instance, independent from the vehicle configurations.
+     *
+     * Index 0 is the depot. Instances are read either from the text files in `problems/data` or
+     * from the versioned binary format below, which may additionally store the precomputed
+     * distance matrix so that repeated runs skip the O(n^2) computation.
+     *
+     * Binary layout (native byte order, every section 8-byte aligned):
+     * - `_BinaryHeader`
+     * - x, y, demand, truck service time, drone service time: `nodes` doubles each
+     * - dronable flags: `nodes` bytes, zero-padded to a multiple of 8
+     * - distance matrix (only if `_HAS_DISTANCES` is set): `nodes * nodes` doubles, row-major
+     *
+     * The hash covers every section except the distance matrix, which is derived data.
+     *
+     * Standalone matrices (e.g. road distances for trucks) use `_MatrixHeader` followed by
+     * `nodes * nodes` doubles, or plain whitespace-separated text.
+     */
+    class InstanceData
+    {
+    private:
+        static constexpr char _MAGIC[8] = {'D', '2', 'D', 'I', 'N', 'S', 'T', '\0'};
+        static constexpr std::uint32_t _VERSION = 1;
+        static constexpr std::uint32_t _HAS_DISTANCES = 1;
+
+        struct _BinaryHeader
+        {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t flags;
+            std::uint64_t nodes;
+            std::uint64_t trucks_count;
+            std::uint64_t drones_count;
+            std::uint64_t hash;
+            double average_distance;
+        };
+
+        static_assert(sizeof(_BinaryHeader) % 8 == 0);
+
+        static constexpr char _MATRIX_MAGIC[8] = {'D', '2', 'D', 'M', 'A', 'T', 'R', 'X'};
+
+        struct _MatrixHeader
+        {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t reserved;
+            std::uint64_t nodes;
+        };
+
+        static_assert(sizeof(_MatrixHeader) % 8 == 0);
+
+        static std::size_t _padded(const std::size_t &size)
+        {
+            return (size + 7) & ~static_cast<std::size_t>(7);
+        }
+
+        /** @brief 64-bit FNV-1a */
+        static std::uint64_t _hash(const char *data, const std::size_t &size, std::uint64_t hash = 14695981039346656037ull)
+        {
+            for (std::size_t i = 0; i < size; i++)
+            {
+                hash ^= static_cast<unsigned char>(data[i]);
+                hash *= 1099511628211ull;
+            }
+
+            return hash;
+        }
+
+        static InstanceData _read_text(const std::string_view &data, const std::string &path);
+        static InstanceData _read_binary(const std::shared_ptr<utils::MappedFile> &file, const std::string &path);
+
+    public:
+        std::size_t trucks_count = 0, drones_count = 0;
+        std::vector<double> x, y, demands, truck_service_time, drone_service_time;
+        std::vector<bool> dronable;
+
+        // Present only when stored in a binary file
+        std::optional<utils::SquareMatrix<double>> distances;
+        double average_distance = 0;
+
+        /** @brief The number of customers, excluding the depot */
+        std::size_t customers_count() const
+        {
+            return x.size() - 1;
+        }
+
+        /**
+         * @brief Read an instance file, detecting its format from its content.
+         *
+         * @param path The path to a text or binary instance file
+         * @return The instance data. For binary files, the distance matrix is mapped without copying.
+         */
+        static InstanceData read(const std::string &path);
+
+        /**
+         * @brief Write this instance in binary format.
+         *
+         * @param path The output path
+         * @param with_distances Whether to store the distance matrix (computed if not present)
+         */
+        void write_binary(const std::string &path, const bool with_distances) const;
+
+        /**
+         * @brief Read a standalone square matrix, detecting its format from its content.
+         *
+         * Binary matrices are mapped without copying, text matrices are parsed directly from the
+         * mapped file.
+         *
+         * @param path The path to the matrix file
+         * @return The matrix
+         */
+        static utils::SquareMatrix<double> read_matrix(const std::string &path);
+
+        /**
+         * @brief Write a standalone square matrix in binary format.
+         *
+         * @param path The output path
+         * @param matrix The matrix to write
+         */
+        static void write_matrix(const std::string &path, const utils::SquareMatrix<double> &matrix);
+
+        /**
+         * @brief Compute the Euclidean distance matrix and the average distance between distinct nodes.
+         */
+        static std::pair<utils::SquareMatrix<double>, double> euclidean_distances(const std::vector<double> &x, const std::vector<double> &y);
+    };
+
+    InstanceData InstanceData::read(const std::string &path)
+    {
+        auto file = std::make_shared<utils::MappedFile>(path);
+        if (file->size() >= sizeof(_MAGIC) && std::memcmp(file->data(), _MAGIC, sizeof(_MAGIC)) == 0)
+        {
+            return _read_binary(file, path);
+        }
+
+        return _read_text(file->view(), path);
+    }
+
+    InstanceData InstanceData::_read_text(const std::string_view &data, const std::string &path)
+    {
+        auto header = [&data, &path](const std::string_view &key)
+        {
+            auto position = data.find(key);
+            if (position == std::string_view::npos)
+            {
+                throw std::runtime_error(utils::format("Missing \"%s\" in %s", std::string(key).c_str(), path.c_str()));
+            }
+
+            std::size_t result;
+            auto begin = data.data() + position + key.size();
+            if (std::from_chars(begin, data.data() + data.size(), result).ec != std::errc())
+            {
+                throw std::runtime_error(utils::format("Invalid \"%s\" in %s", std::string(key).c_str(), path.c_str()));
+            }
+
+            return result;
+        };
+
+        InstanceData result;
+        std::size_t customers_count = header("Customers ");
+        result.trucks_count = header("number_truck ");
+        result.drones_count = header("number_drone ");
+
+        result.x = {0};
+        result.y = {0};
+        result.demands = {0};
+
+        // Customer lines consist of exactly 3 numbers: x, y and demand
+        auto is_whitespace = [](const char c)
+        { return c == ' ' || c == '\t' || c == '\r'; };
+        std::size_t offset = 0;
+        while (offset < data.size())
+        {
+            auto line_end = data.find('\n', offset);
+            if (line_end == std::string_view::npos)
+            {
+                line_end = data.size();
+            }
+
+            std::array<std::string_view, 3> tokens;
+            std::size_t tokens_count = 0;
+            for (std::size_t i = offset; i < line_end;)
+            {
+                if (is_whitespace(data[i]))
+                {
+                    i++;
+                    continue;
+                }
+
+                std::size_t j = i;
+                while (j < line_end && !is_whitespace(data[j]))
+                {
+                    j++;
+                }
+
+                if (tokens_count < tokens.size())
+                {
+                    tokens[tokens_count] = data.substr(i, j - i);
+                }
+
+                tokens_count++;
+                i = j;
+            }
+
+            offset = line_end + 1;
+            if (tokens_count != 3 ||
+                tokens[0].find_first_not_of("-0123456789.") != std::string_view::npos ||
+                tokens[1].find_first_not_of("-0123456789.") != std::string_view::npos ||
+                tokens[2].find_first_not_of("0123456789.") != std::string_view::npos)
+            {
+                continue;
+            }
+
+            result.x.push_back(1609.34 * utils::parse_number<double>(tokens[0]));
+            result.y.push_back(1609.34 * utils::parse_number<double>(tokens[1]));
+            result.demands.push_back(0.453592 * utils::parse_number<double>(tokens[2]));
+        }
+
+        if (result.customers_count() != customers_count)
+        {
+            throw std::runtime_error(utils::format("Expected %lu customers in %s, found %lu", customers_count, path.c_str(), result.customers_count()));
+        }
+
+        result.truck_service_time.assign(customers_count + 1, 0);
+        result.drone_service_time.assign(customers_count + 1, 0);
+        result.dronable.assign(customers_count + 1, true);
+
+        return result;
+    }
+
+    InstanceData InstanceData::_read_binary(const std::shared_ptr<utils::MappedFile> &file, const std::string &path)
+    {
+        if (file->size() < sizeof(_BinaryHeader))
+        {
+            throw std::runtime_error(utils::format("Truncated header in %s", path.c_str()));
+        }
+
+        _BinaryHeader header;
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (header.version != _VERSION)
+        {
+            throw std::runtime_error(utils::format("Unsupported binary instance version %u in %s", header.version, path.c_str()));
+        }
+
+        // Reject node counts the file cannot hold before any size computation can overflow
+        const std::size_t nodes = header.nodes;
+        if (nodes == 0 || nodes > file->size() / sizeof(double) ||
+            ((header.flags & _HAS_DISTANCES) && nodes > file->size() / (nodes * sizeof(double))))
+        {
+            throw std::runtime_error(utils::format("Truncated binary instance %s", path.c_str()));
+        }
+
+        const std::size_t body_size = 5 * nodes * sizeof(double) + _padded(nodes);
+        const std::size_t matrix_size = (header.flags & _HAS_DISTANCES) ? nodes * nodes * sizeof(double) : 0;
+        if (file->size() < sizeof(_BinaryHeader) + body_size + matrix_size)
+        {
+            throw std::runtime_error(utils::format("Truncated binary instance %s", path.c_str()));
+        }
+
+        const char *body = file->data() + sizeof(_BinaryHeader);
+        if (_hash(body, body_size) != header.hash)
+        {
+            throw std::runtime_error(utils::format("Hash mismatch in %s", path.c_str()));
+        }
+
+        InstanceData result;
+        result.trucks_count = header.trucks_count;
+        result.drones_count = header.drones_count;
+
+        auto read_array = [&body, &nodes](std::vector<double> &array)
+        {
+            array.resize(nodes);
+            std::memcpy(array.data(), body, nodes * sizeof(double));
+            body += nodes * sizeof(double);
+        };
+        read_array(result.x);
+        read_array(result.y);
+        read_array(result.demands);
+        read_array(result.truck_service_time);
+        read_array(result.drone_service_time);
+
+        result.dronable.resize(nodes);
+        for (std::size_t i = 0; i < nodes; i++)
+        {
+            result.dronable[i] = body[i] != 0;
+        }
+
+        if (header.flags & _HAS_DISTANCES)
+        {
+            result.distances.emplace(nodes, file, sizeof(_BinaryHeader) + body_size);
+            result.average_distance = header.average_distance;
+        }
+
+        return result;
+    }
+
+    void InstanceData::write_binary(const std::string &path, const bool with_distances) const
+    {
+        const std::size_t nodes = x.size();
+
+        std::string body;
+        body.reserve(5 * nodes * sizeof(double) + _padded(nodes));
+        for (auto array : {&x, &y, &demands, &truck_service_time, &drone_service_time})
+        {
+            body.append(reinterpret_cast<const char *>(array->data()), nodes * sizeof(double));
+        }
+        for (std::size_t i = 0; i < nodes; i++)
+        {
+            body.push_back(dronable[i] ? 1 : 0);
+        }
+        body.resize(5 * nodes * sizeof(double) + _padded(nodes), 0);
+
+        _BinaryHeader header = {};
+        std::memcpy(header.magic, _MAGIC, sizeof(_MAGIC));
+        header.version = _VERSION;
+        header.nodes = nodes;
+        header.trucks_count = trucks_count;
+        header.drones_count = drones_count;
+        header.hash = _hash(body.data(), body.size());
+
+        std::optional<std::pair<utils::SquareMatrix<double>, double>> computed;
+        const utils::SquareMatrix<double> *matrix = nullptr;
+        if (with_distances)
+        {
+            header.flags |= _HAS_DISTANCES;
+            if (distances.has_value())
+            {
+                matrix = &distances.value();
+                header.average_distance = average_distance;
+            }
+            else
+            {
+                computed = euclidean_distances(x, y);
+                matrix = &computed->first;
+                header.average_distance = computed->second;
+            }
+        }
+
+        std::ofstream output(path, std::ios::binary | std::ios::trunc);
+        if (!output)
+        {
+            throw std::runtime_error(utils::format("Unable to open \"%s\" for writing", path.c_str()));
+        }
+
+        output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        output.write(body.data(), body.size());
+        if (matrix != nullptr)
+        {
+            output.write(reinterpret_cast<const char *>(matrix->data()), nodes * nodes * sizeof(double));
+        }
+
+        if (!output)
+        {
+            throw std::runtime_error(utils::format("Unable to write \"%s\"", path.c_str()));
+        }
+    }
+
+    utils::SquareMatrix<double> InstanceData::read_matrix(const std::string &path)
+    {
+        auto file = std::make_shared<utils::MappedFile>(path);
+        if (file->size() >= sizeof(_MATRIX_MAGIC) && std::memcmp(file->data(), _MATRIX_MAGIC, sizeof(_MATRIX_MAGIC)) == 0)
+        {
+            if (file->size() < sizeof(_MatrixHeader))
+            {
+                throw std::runtime_error(utils::format("Truncated header in %s", path.c_str()));
+            }
+
+            _MatrixHeader header;
+            std::memcpy(&header, file->data(), sizeof(header));
+            if (header.version != _VERSION)
+            {
+                throw std::runtime_error(utils::format("Unsupported binary matrix version %u in %s", header.version, path.c_str()));
+            }
+
+            return utils::SquareMatrix<double>(header.nodes, file, sizeof(_MatrixHeader));
+        }
+
+        // The first row gives the size of the matrix, the values are then parsed in place
+        const char *current = file->data(), *end = file->data() + file->size();
+        const auto next = [&current, &end, &file, &path](double &value)
+        {
+            while (current != end && std::isspace(static_cast<unsigned char>(*current)))
+            {
+                current++;
+            }
+
+            if (current == end)
+            {
+                return false;
+            }
+
+            auto [ptr, error] = std::from_chars(current, end, value);
+            if (error != std::errc())
+            {
+                throw std::runtime_error(utils::format("Invalid number at offset %ld in %s", current - file->data(), path.c_str()));
+            }
+
+            current = ptr;
+            return true;
+        };
+
+        std::size_t nodes = 0;
+        const char *c = current;
+        while (c != end && std::isspace(static_cast<unsigned char>(*c)))
+        {
+            c++;
+        }
+
+        while (c != end && *c != '\n')
+        {
+            if (std::isspace(static_cast<unsigned char>(*c)))
+            {
+                c++;
+                continue;
+            }
+
+            nodes++;
+            while (c != end && !std::isspace(static_cast<unsigned char>(*c)))
+            {
+                c++;
+            }
+        }
+
+        utils::SquareMatrix<double> result(nodes);
+        std::size_t count = 0;
+        for (double value; next(value); count++)
+        {
+            if (count < nodes * nodes)
+            {
+                result[0][count] = value;
+            }
+        }
+
+        if (nodes == 0 || count != nodes * nodes)
+        {
+            throw std::runtime_error(utils::format("%s does not contain a square matrix (%lu values in the first row, %lu in total)", path.c_str(), nodes, count));
+        }
+
+        return result;
+    }
+
+    void InstanceData::write_matrix(const std::string &path, const utils::SquareMatrix<double> &matrix)
+    {
+        _MatrixHeader header = {};
+        std::memcpy(header.magic, _MATRIX_MAGIC, sizeof(_MATRIX_MAGIC));
+        header.version = _VERSION;
+        header.nodes = matrix.size();
+
+        std::ofstream output(path, std::ios::binary | std::ios::trunc);
+        if (!output)
+        {
+            throw std::runtime_error(utils::format("Unable to open \"%s\" for writing", path.c_str()));
+        }
+
+        output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        output.write(reinterpret_cast<const char *>(matrix.data()), matrix.size() * matrix.size() * sizeof(double));
+        if (!output)
+        {
+            throw std::runtime_error(utils::format("Unable to write \"%s\"", path.c_str()));
+        }
+    }
+
+    std::pair<utils::SquareMatrix<double>, double> InstanceData::euclidean_distances(const std::vector<double> &x, const std::vector<double> &y)
+    {
+        const std::size_t nodes = x.size();
+        utils::SquareMatrix<double> distances(nodes);
+        for (std::size_t i = 0; i < nodes; i++)
+        {
+            for (std::size_t j = i + 1; j < nodes; j++)
+            {
+                distances[i][j] = distances[j][i] = utils::distance(x[i] - x[j], y[i] - y[j]);
+            }
+        }
+
+        double average_distance = 0;
+        for (std::size_t i = 0; i < nodes; i++)
+        {
+            for (std::size_t j = i + 1; j < nodes; j++)
+            {
+                average_distance += distances[i][j];
+            }
+        }
+
+        average_distance /= nodes * (nodes - 1) / 2;
+
+        return std::make_pair(distances, average_distance);
+    }
+}
@@ -0,0 +1,299 @@
+#pragma once
+
+#include "allocations.hpp"
+#include "utils.hpp"
+
+namespace utils
+{
+    /**
+     * @brief Run-time switchable profiling zones and counters, written as a
+     * [Chrome trace](https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU)
+     * that can be opened in `chrome://tracing` or [Perfetto](https://ui.perfetto.dev).
+     *
+     * Instrumentation is disabled unless `open` is called, in which case every probe whose level
+     * does not exceed the selected level is recorded. Enabled zones also delimit the allocation
+     * counters of `AllocationTracker`. A disabled probe costs a single predictable
+     * branch, so release builds can be profiled without recompiling.
+     */
+    class Instrumentation
+    {
+    public:
+        /** @brief Search phases: initialization, tabu iterations, destroy and repair, post-optimization */
+        static constexpr int PHASES = 1;
+
+        /** @brief Neighborhood moves and their counters */
+        static constexpr int NEIGHBORHOODS = 2;
+
+        /** @brief Individual route optimizations and solution evaluations */
+        static constexpr int DETAILS = 3;
+
+        using clock = std::chrono::steady_clock;
+
+    private:
+        // Set by `open` and `close` on the main thread, read by the probes of every thread
+        static inline std::atomic<int> _level = 0;
+        static inline std::ofstream _output;
+        static inline std::mutex _mutex;
+        static inline bool _first = true;
+        static inline clock::time_point _start;
+        static inline std::atomic<std::size_t> _threads = 0;
+
+        static std::size_t _thread_id()
+        {
+            thread_local std::size_t id = _threads.fetch_add(1, std::memory_order_relaxed) + 1;
+            return id;
+        }
+
+        static double _timestamp(const clock::time_point &time)
+        {
+            return std::chrono::duration<double, std::micro>(time - _start).count();
+        }
+
+        static void _write_string(const std::string_view &value)
+        {
+            _output << '"';
+            for (auto c : value)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    _output << '\\' << c;
+                }
+                else if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    // Control characters are not allowed in JSON strings
+                    char escaped[7];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+                    _output << escaped;
+                }
+                else
+                {
+                    _output << c;
+                }
+            }
+            _output << '"';
+        }
+
+        // The caller must hold `_mutex`
+        static void _begin_event()
+        {
+            _output << (_first ? "[\n" : ",\n");
+            _first = false;
+        }
+
+    public:
+        /** @brief Whether probes of the given level are recorded */
+        static bool enabled(const int &level)
+        {
+            return _level.load(std::memory_order_relaxed) >= level;
+        }
+
+        static int level()
+        {
+            return _level.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Start recording to a trace file.
+         *
+         * @param path The output path. If empty, probes are enabled without writing a trace, e.g. to
+         * attribute allocations to zones (see `AllocationTracker`).
+         * @param level The maximum level of recorded probes, 0 disables instrumentation
+         */
+        static void open(const std::string &path, const int &level)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (!path.empty())
+            {
+                _output.open(path);
+                if (!_output)
+                {
+                    throw std::runtime_error(utils::format("Unable to open \"%s\" for writing", path.c_str()));
+                }
+            }
+
+            _output << std::fixed << std::setprecision(3);
+            _first = true;
+            _start = clock::now();
+            _level.store(level, std::memory_order_relaxed);
+        }
+
+        /** @brief Stop recording and close the trace file */
+        static void close()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_output.is_open())
+            {
+                _output << (_first ? "[]\n" : "\n]\n");
+                _output.close();
+            }
+
+            _level.store(0, std::memory_order_relaxed);
+        }
+
+        /** @brief Record a completed zone, see `InstrumentZone` */
+        static void complete(const char *category, const std::string_view &name, const clock::time_point &begin, const clock::time_point &end)
+        {
+            auto tid = _thread_id();
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_output.is_open())
+            {
+                return;
+            }
+
+            _begin_event();
+            _output << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << tid << ",\"cat\":\"" << category << "\",\"name\":";
+            _write_string(name);
+            _output << ",\"ts\":" << _timestamp(begin) << ",\"dur\":" << _timestamp(end) - _timestamp(begin) << "}";
+        }
+
+        /**
+         * @brief Record the current values of a counter track.
+         *
+         * @param name The track name
+         * @param values The series of the track and their values
+         */
+        static void counter(const std::string_view &name, const std::vector<std::pair<std::string_view, double>> &values)
+        {
+            auto now = clock::now();
+            auto tid = _thread_id();
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_output.is_open())
+            {
+                return;
+            }
+
+            _begin_event();
+            _output << "{\"ph\":\"C\",\"pid\":1,\"tid\":" << tid << ",\"name\":";
+            _write_string(name);
+            _output << ",\"ts\":" << _timestamp(now) << ",\"args\":{";
+            for (std::size_t i = 0; i < values.size(); i++)
+            {
+                if (i > 0)
+                {
+                    _output << ',';
+                }
+                _write_string(values[i].first);
+                _output << ':' << values[i].second;
+            }
+            _output << "}}";
+        }
+    };
+
+    /**
+     * @brief Records the lifetime of a scope as a zone of the instrumentation trace.
+     *
+     * The name is only materialized when the zone is enabled: it may be a string or a callable
+     * returning one, so that e.g. `[this] { return label(); }` costs nothing when disabled.
+     */
+    class InstrumentZone
+    {
+    private:
+        const char *_category;
+        std::string _name;
+        Instrumentation::clock::time_point _begin;
+        bool _enabled;
+
+    public:
+        template <typename _Name>
+        InstrumentZone(const int &level, const char *category, const _Name &name)
+            : _category(category), _enabled(Instrumentation::enabled(level))
+        {
+            if (_enabled) [[unlikely]]
+            {
+                if constexpr (std::is_invocable_v<const _Name &>)
+                {
+                    _name = name();
+                }
+                else
+                {
+                    _name = name;
+                }
+
+                AllocationTracker::push(_name);
+                _begin = Instrumentation::clock::now();
+            }
+        }
+
+        InstrumentZone(const InstrumentZone &) = delete;
+        InstrumentZone &operator=(const InstrumentZone &) = delete;
+
+        ~InstrumentZone()
+        {
+            if (_enabled) [[unlikely]]
+            {
+                auto end = Instrumentation::clock::now();
+                AllocationTracker::pop();
+                Instrumentation::complete(_category, _name, _begin, end);
+            }
+        }
+    };
+
+    /**
+     * @brief A named event counter, whose value is written to the trace by `sample`.
+     *
+     * Counters are meant to be declared as `static` objects.
+     */
+    class InstrumentCounter
+    {
+    private:
+        static inline std::mutex _mutex;
+        static inline std::vector<InstrumentCounter *> _counters;
+
+        const char *_name;
+        const int _level;
+        std::atomic<std::uint64_t> _value = 0;
+
+    public:
+        InstrumentCounter(const char *name, const int &level) : _name(name), _level(level)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _counters.push_back(this);
+        }
+
+        InstrumentCounter(const InstrumentCounter &) = delete;
+        InstrumentCounter &operator=(const InstrumentCounter &) = delete;
+
+        ~InstrumentCounter()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _counters.erase(std::find(_counters.begin(), _counters.end(), this));
+        }
+
+        void add(const std::uint64_t &delta = 1)
+        {
+            if (Instrumentation::enabled(_level)) [[unlikely]]
+            {
+                _value.fetch_add(delta, std::memory_order_relaxed);
+            }
+        }
+
+        std::uint64_t value() const
+        {
+            return _value.load(std::memory_order_relaxed);
+        }
+
+        /** @brief Write the current values of all enabled counters to the trace */
+        static void sample()
+        {
+            std::vector<std::pair<std::string_view, double>> values;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                for (auto counter : _counters)
+                {
+                    if (Instrumentation::enabled(counter->_level))
+                    {
+                        values.emplace_back(counter->_name, counter->value());
+                    }
+                }
+            }
+
+            if (!values.empty())
+            {
+                Instrumentation::counter("counters", values);
+            }
+        }
+    };
+}
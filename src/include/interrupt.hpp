@@ -0,0 +1,87 @@
+#pragma once
+
+#include "format.hpp"
+
+namespace utils
+{
+    /**
+     * @brief A process-wide stop request, set by SIGINT, SIGTERM or a "stop" line on a control file.
+     *
+     * The request is a lock-free atomic flag, so that it can be set from a signal handler. The search
+     * polls it (see `d2d::Problem::stopped`) and finishes with its best solution so far.
+     */
+    class Interruption
+    {
+    private:
+        static_assert(std::atomic<bool>::is_always_lock_free);
+
+        static inline std::atomic<bool> _requested = false;
+
+        static void _handler(int signal)
+        {
+            _requested.store(true, std::memory_order_relaxed);
+
+            // A second signal terminates the process as usual
+            std::signal(signal, SIG_DFL);
+        }
+
+    public:
+        /** @brief Request the search to stop */
+        static void request()
+        {
+            _requested.store(true, std::memory_order_relaxed);
+        }
+
+        /** @brief Whether a stop has been requested */
+        static bool requested()
+        {
+            return _requested.load(std::memory_order_relaxed);
+        }
+
+        /** @brief Request a stop on the first SIGINT or SIGTERM */
+        static void install_signal_handlers()
+        {
+            std::signal(SIGINT, _handler);
+            std::signal(SIGTERM, _handler);
+        }
+
+        /**
+         * @brief Request a stop when a "stop" line is read from a control file, typically a named pipe.
+         *
+         * The file is read by a detached thread and reopened whenever its writer closes it, so that
+         * writers may come and go.
+         *
+         * @param path The control file path, which must exist
+         */
+        static void watch(const std::string &path)
+        {
+            // Opening a named pipe blocks until a writer opens it, so only its existence is checked here
+            if (!std::filesystem::exists(path))
+            {
+                throw std::runtime_error(format("Control file %s does not exist", path.c_str()));
+            }
+
+            std::thread(
+                [path]()
+                {
+                    while (!requested())
+                    {
+                        std::ifstream control(path);
+                        std::string line;
+                        while (std::getline(control, line))
+                        {
+                            line.erase(line.find_last_not_of(" \t\r") + 1);
+                            if (line == "stop")
+                            {
+                                request();
+                                return;
+                            }
+                        }
+
+                        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                    }
+                })
+                .detach();
+        }
+    };
+}
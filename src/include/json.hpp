@@ -0,0 +1,308 @@
+#pragma once
+
+#include "format.hpp"
+
+namespace utils
+{
+    /**
+     * @brief A minimal read-only JSON document model.
+     *
+     * Strings and object keys are views into the parsed text (escape sequences are kept verbatim),
+     * so the source buffer must outlive the parsed document. Object members keep their order of
+     * appearance.
+     */
+    class JSON
+    {
+    public:
+        enum class Type
+        {
+            null,
+            boolean,
+            number,
+            string,
+            array,
+            object
+        };
+
+    private:
+        Type _type = Type::null;
+        bool _boolean = false;
+        double _number = 0;
+        std::string_view _string;
+        std::vector<JSON> _array;
+        std::vector<std::pair<std::string_view, JSON>> _object;
+
+        class _Parser
+        {
+        private:
+            const char *_current;
+            const char *const _end;
+
+            [[noreturn]] void _fail(const char *message) const
+            {
+                throw std::runtime_error(format("Invalid JSON: %s", message));
+            }
+
+            void _skip_whitespace()
+            {
+                while (_current != _end && (*_current == ' ' || *_current == '\t' || *_current == '\n' || *_current == '\r'))
+                {
+                    _current++;
+                }
+            }
+
+            void _expect(const char c)
+            {
+                _skip_whitespace();
+                if (_current == _end || *_current != c)
+                {
+                    _fail(format("expected '%c'", c).c_str());
+                }
+
+                _current++;
+            }
+
+            void _expect_literal(const std::string_view &literal)
+            {
+                if (static_cast<std::size_t>(_end - _current) < literal.size() || std::string_view(_current, literal.size()) != literal)
+                {
+                    _fail("unexpected token");
+                }
+
+                _current += literal.size();
+            }
+
+            std::string_view _parse_string()
+            {
+                _expect('"');
+                const char *begin = _current;
+                while (_current != _end && *_current != '"')
+                {
+                    if (*_current == '\\')
+                    {
+                        _current++;
+                        if (_current == _end)
+                        {
+                            break;
+                        }
+                    }
+
+                    _current++;
+                }
+
+                if (_current == _end)
+                {
+                    _fail("unterminated string");
+                }
+
+                return std::string_view(begin, _current++ - begin);
+            }
+
+        public:
+            _Parser(const std::string_view &text) : _current(text.data()), _end(text.data() + text.size()) {}
+
+            JSON parse_value()
+            {
+                JSON result;
+
+                _skip_whitespace();
+                if (_current == _end)
+                {
+                    _fail("unexpected end of input");
+                }
+
+                switch (*_current)
+                {
+                case '{':
+                    result._type = Type::object;
+                    _current++;
+                    _skip_whitespace();
+                    if (_current != _end && *_current == '}')
+                    {
+                        _current++;
+                        break;
+                    }
+
+                    while (true)
+                    {
+                        auto key = _parse_string();
+                        _expect(':');
+                        result._object.emplace_back(key, parse_value());
+
+                        _skip_whitespace();
+                        if (_current != _end && *_current == ',')
+                        {
+                            _current++;
+                            continue;
+                        }
+
+                        _expect('}');
+                        break;
+                    }
+                    break;
+
+                case '[':
+                    result._type = Type::array;
+                    _current++;
+                    _skip_whitespace();
+                    if (_current != _end && *_current == ']')
+                    {
+                        _current++;
+                        break;
+                    }
+
+                    while (true)
+                    {
+                        result._array.push_back(parse_value());
+
+                        _skip_whitespace();
+                        if (_current != _end && *_current == ',')
+                        {
+                            _current++;
+                            continue;
+                        }
+
+                        _expect(']');
+                        break;
+                    }
+                    break;
+
+                case '"':
+                    result._type = Type::string;
+                    result._string = _parse_string();
+                    break;
+
+                case 't':
+                    result._type = Type::boolean;
+                    result._boolean = true;
+                    _expect_literal("true");
+                    break;
+
+                case 'f':
+                    result._type = Type::boolean;
+                    _expect_literal("false");
+                    break;
+
+                case 'n':
+                    _expect_literal("null");
+                    break;
+
+                default:
+                {
+                    // std::from_chars does not accept a leading '+', neither does JSON
+                    auto [ptr, error] = std::from_chars(_current, _end, result._number);
+                    if (error != std::errc())
+                    {
+                        _fail("invalid number");
+                    }
+
+                    result._type = Type::number;
+                    _current = ptr;
+                }
+                }
+
+                return result;
+            }
+
+            void finish()
+            {
+                _skip_whitespace();
+                if (_current != _end)
+                {
+                    _fail("trailing characters");
+                }
+            }
+        };
+
+    public:
+        /**
+         * @brief Parse a JSON document.
+         *
+         * @param text The JSON text, which must outlive the returned document
+         * @return The parsed document
+         * @note `std::runtime_error` is thrown on malformed input.
+         */
+        static JSON parse(const std::string_view &text)
+        {
+            _Parser parser(text);
+            auto result = parser.parse_value();
+            parser.finish();
+            return result;
+        }
+
+        Type type() const
+        {
+            return _type;
+        }
+
+        bool boolean() const
+        {
+            if (_type != Type::boolean)
+            {
+                throw std::runtime_error("JSON value is not a boolean");
+            }
+
+            return _boolean;
+        }
+
+        double number() const
+        {
+            if (_type != Type::number)
+            {
+                throw std::runtime_error("JSON value is not a number");
+            }
+
+            return _number;
+        }
+
+        std::string_view string() const
+        {
+            if (_type != Type::string)
+            {
+                throw std::runtime_error("JSON value is not a string");
+            }
+
+            return _string;
+        }
+
+        const std::vector<JSON> &array() const
+        {
+            if (_type != Type::array)
+            {
+                throw std::runtime_error("JSON value is not an array");
+            }
+
+            return _array;
+        }
+
+        const std::vector<std::pair<std::string_view, JSON>> &object() const
+        {
+            if (_type != Type::object)
+            {
+                throw std::runtime_error("JSON value is not an object");
+            }
+
+            return _object;
+        }
+
+        /**
+         * @brief Look up an object member.
+         *
+         * @param key The member key
+         * @return The first member with the given key
+         * @note `std::out_of_range` is thrown if no such member exists.
+         */
+        const JSON &operator[](const std::string_view &key) const
+        {
+            for (auto &[k, value] : object())
+            {
+                if (k == key)
+                {
+                    return value;
+                }
+            }
+
+            throw std::out_of_range(format("JSON object has no key \"%s\"", std::string(key).c_str()));
+        }
+    };
+}
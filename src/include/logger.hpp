@@ -1,7 +1,10 @@
 #pragma once
 
+#include "allocations.hpp"
 #include "parent.hpp"
 #include "routes.hpp"
+#include "trace.hpp"
+#include "neighborhoods/statistics.hpp"
 
 namespace d2d
 {
@@ -13,9 +16,292 @@ namespace d2d
         std::vector<std::array<double, 4>> _coefficients;
         std::vector<std::vector<std::shared_ptr<ST>>> _elite_set;
         std::vector<std::pair<std::string, std::vector<std::size_t>>> _neighborhoods;
+        std::vector<std::pair<std::string, NeighborhoodStatistics>> _statistics;
+        std::vector<std::tuple<double, std::size_t, double>> _anytime;
+
+        std::unique_ptr<TraceWriter> _trace;
+
+        // The results file, opened by `open_output` and written by `_write_json_lines`
+        std::ofstream _output;
+        const std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+
+        static std::string _config_label()
+        {
+            auto problem = d2d::Problem::get_instance();
+            if (problem->linear != nullptr)
+            {
+                return "linear";
+            }
+            else if (problem->nonlinear != nullptr)
+            {
+                return "nonlinear";
+            }
+            else if (problem->endurance != nullptr)
+            {
+                return problem->endurance->fixed_time == 1e9 ? "unlimited" : "endurance";
+            }
+
+            throw std::runtime_error("No drone configuration was found. This should never happen.");
+        }
+
+        static std::string _json_string(const std::string &value)
+        {
+            std::string result = "\"";
+            for (auto &c : value)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    result += '\\';
+                    result += c;
+                }
+                else if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    result += utils::format("\\u%04x", c);
+                }
+                else
+                {
+                    result += c;
+                }
+            }
+
+            return result + "\"";
+        }
+
+        static void _json_solution(std::ostream &stream, const std::shared_ptr<ST> &ptr)
+        {
+            if (ptr == nullptr)
+            {
+                stream << "null";
+                return;
+            }
+
+            stream << "{\"cost\": " << ptr->cost()
+                   << ", \"working_time\": " << ptr->working_time
+                   << ", \"drone_energy_violation\": " << ptr->drone_energy_violation
+                   << ", \"capacity_violation\": " << ptr->capacity_violation
+                   << ", \"waiting_time_violation\": " << ptr->waiting_time_violation
+                   << ", \"fixed_time_violation\": " << ptr->fixed_time_violation
+                   << ", \"truck_paths\": " << ptr->truck_routes()
+                   << ", \"drone_paths\": " << ptr->drone_routes()
+                   << ", \"feasible\": " << (ptr->feasible ? "true" : "false")
+                   << ", \"truck_working_time\": " << ptr->truck_working_time()
+                   << ", \"drone_working_time\": " << ptr->drone_working_time()
+                   << "}";
+        }
+
+        static void _json_counters(std::ostream &stream, const NeighborhoodStatistics::Counters &counters)
+        {
+            stream << "{\"generated\": " << counters.generated
+                   << ", \"pruned\": " << counters.pruned
+                   << ", \"evaluated\": " << counters.evaluated
+                   << ", \"feasible\": " << counters.feasible
+                   << ", \"tabu_rejected\": " << counters.tabu_rejected
+                   << ", \"aspiration_hits\": " << counters.aspiration_hits
+                   << ", \"wins\": " << counters.wins
+                   << ", \"improvement\": " << counters.improvement
+                   << "}";
+        }
+
+        /** @brief Print the per-neighborhood counters as a table to stderr */
+        void _report_statistics() const
+        {
+            if (_statistics.empty())
+            {
+                return;
+            }
+
+            std::cerr << utils::format(
+                "%-24s %-12s %12s %12s %12s %12s %12s %12s %8s %14s %10s\n",
+                "Neighborhood", "Pair", "Generated", "Pruned", "Evaluated", "Feasible", "Tabu", "Aspiration", "Wins", "Improvement", "Time (s)");
+            for (auto &[label, statistics] : _statistics)
+            {
+                for (std::size_t pair = 0; pair < statistics.pairs.size(); pair++)
+                {
+                    auto &counters = statistics.pairs[pair];
+                    if (counters.generated == 0 && counters.pruned == 0)
+                    {
+                        continue;
+                    }
+
+                    std::cerr << utils::format(
+                        "%-24s %-12s %12lu %12lu %12lu %12lu %12lu %12lu %8lu %14.2lf %10s\n",
+                        label.c_str(), NeighborhoodStatistics::PAIR_LABELS[pair],
+                        counters.generated, counters.pruned, counters.evaluated, counters.feasible, counters.tabu_rejected,
+                        counters.aspiration_hits, counters.wins, counters.improvement, "");
+                }
+
+                auto total = statistics.total();
+                std::cerr << utils::format(
+                    "%-24s %-12s %12lu %12lu %12lu %12lu %12lu %12lu %8lu %14.2lf %10.3lf\n",
+                    label.c_str(), "total",
+                    total.generated, total.pruned, total.evaluated, total.feasible, total.tabu_rejected,
+                    total.aspiration_hits, total.wins, total.improvement, statistics.elapsed);
+            }
+        }
+
+        /** @brief Print the allocation counters of each instrumentation zone as a table to stderr */
+        static void _report_allocations()
+        {
+            if constexpr (utils::AllocationTracker::enabled)
+            {
+                const auto print = [](const std::string &zone, const utils::AllocationTracker::Counters &counters)
+                {
+                    std::cerr << utils::format(
+                        "%-48s %12lu %14lu %14lu %14ld\n",
+                        zone.c_str(), counters.activations, counters.allocations, counters.bytes, counters.peak_bytes);
+                };
+
+                std::cerr << utils::format("%-48s %12s %14s %14s %14s\n", "Zone", "Activations", "Allocations", "Bytes", "Peak bytes");
+                for (auto &[zone, counters] : utils::AllocationTracker::zones())
+                {
+                    print(zone, counters);
+                }
+                print("total", utils::AllocationTracker::total());
+            }
+        }
+
+        static void _json_allocations(std::ostream &stream, const std::string &zone, const utils::AllocationTracker::Counters &counters)
+        {
+            stream << "{\"type\": \"allocations\", \"zone\": " << _json_string(zone)
+                   << ", \"activations\": " << counters.activations
+                   << ", \"allocations\": " << counters.allocations
+                   << ", \"bytes\": " << counters.bytes
+                   << ", \"peak_bytes\": " << counters.peak_bytes
+                   << "}\n";
+        }
+
+        /**
+         * @brief Write the result as JSON lines, one object per line with a `type` field:
+         * - `metadata`: run parameters and statistics
+         * - `solution`: the final solution
+         * - `propagation`: one line per lineage entry, from the final solution back to the initial one
+         * - `iteration`: one line per logged iteration (history, progress, coefficients, neighborhood, elite set)
+         * - `statistics`: one line per neighborhood with its counters, see `NeighborhoodStatistics`
+         * - `anytime`: one line per improvement of the best feasible solution, see `improve`
+         * - `allocations`: one line per instrumentation zone and a `total` line, only in builds with
+         *   `-D TRACK_ALLOCATIONS` (see `utils::AllocationTracker`)
+         *
+         * Solutions have the same fields as the ones parsed by `scripts/out.py`.
+         */
+        void _write_json_lines(const std::shared_ptr<ST> &ptr, const std::string &path)
+        {
+            auto &output = _output;
+            output << std::fixed << std::setprecision(6);
+
+            auto problem = d2d::Problem::get_instance();
+
+            std::string initialization_label;
+            for (auto propagation = ptr; propagation != nullptr; propagation = propagation->parent()->ptr)
+            {
+                initialization_label = propagation->parent()->label;
+            }
+
+            output << "{\"type\": \"metadata\""
+                   << ", \"problem\": " << _json_string(problem->name)
+                   << ", \"trucks_count\": " << problem->trucks_count
+                   << ", \"drones_count\": " << problem->drones_count
+                   << ", \"iterations\": " << iterations
+                   << ", \"tabu_size_factor\": " << problem->tabu_size_factor
+                   << ", \"reset_after_factor\": " << problem->reset_after_factor
+                   << ", \"tabu_size\": " << problem->tabu_size
+                   << ", \"reset_after\": " << problem->reset_after
+                   << ", \"max_elite_size\": " << problem->max_elite_size
+                   << ", \"destroy_rate\": " << problem->destroy_rate
+                   << ", \"config\": " << _json_string(_config_label())
+                   << ", \"speed_type\": " << _json_string(problem->drone->speed_type == d2d::StatsType::low ? "low" : "high")
+                   << ", \"range_type\": " << _json_string(problem->drone->range_type == d2d::StatsType::low ? "low" : "high")
+                   << ", \"waiting_time_limit\": " << problem->waiting_time_limit
+                   << ", \"truck_maximum_speed\": " << problem->truck->maximum_speed()
+                   << ", \"endurance_fixed_time\": " << (problem->endurance != nullptr ? problem->endurance->fixed_time : 0)
+                   << ", \"endurance_drone_speed\": " << (problem->endurance != nullptr ? problem->endurance->drone_speed : 0)
+                   << ", \"initialization_label\": " << _json_string(initialization_label)
+                   << ", \"last_improved\": " << last_improved
+                   << ", \"lower_bound\": " << lower_bound
+                   << ", \"stagnation_gain\": " << problem->stagnation_gain
+                   << ", \"stagnation_spread\": " << problem->stagnation_spread
+                   << ", \"elapsed\": " << elapsed.count() / 1000.0
+                   << ", \"strategy\": " << _json_string(problem->strategy)
+                   << "}\n";
+
+            output << "{\"type\": \"solution\", \"solution\": ";
+            _json_solution(output, ptr);
+            output << "}\n";
+
+            for (auto propagation = ptr; propagation != nullptr; propagation = propagation->parent()->ptr)
+            {
+                output << "{\"type\": \"propagation\", \"label\": " << _json_string(propagation->parent()->label) << ", \"solution\": ";
+                _json_solution(output, propagation);
+                output << "}\n";
+            }
+
+            for (std::size_t i = 0; i < _history.size(); i++)
+            {
+                output << "{\"type\": \"iteration\", \"history\": ";
+                _json_solution(output, _history[i]);
+                output << ", \"progress\": ";
+                _json_solution(output, _progress[i]);
+                output << ", \"coefficients\": " << _coefficients[i];
+                output << ", \"neighborhood\": {\"label\": " << _json_string(_neighborhoods[i].first) << ", \"pair\": " << _neighborhoods[i].second << "}";
+
+                std::vector<double> costs(_elite_set[i].size());
+                std::transform(
+                    _elite_set[i].begin(),
+                    _elite_set[i].end(),
+                    costs.begin(),
+                    [](const std::shared_ptr<ST> &ptr)
+                    { return ptr->working_time; });
+                output << ", \"elite_set\": " << costs << "}\n";
+            }
+
+            for (auto &[label, statistics] : _statistics)
+            {
+                output << "{\"type\": \"statistics\", \"neighborhood\": " << _json_string(label)
+                       << ", \"elapsed\": " << statistics.elapsed
+                       << ", \"total\": ";
+                _json_counters(output, statistics.total());
+                output << ", \"pairs\": {";
+                for (std::size_t pair = 0; pair < statistics.pairs.size(); pair++)
+                {
+                    output << (pair == 0 ? "" : ", ") << _json_string(NeighborhoodStatistics::PAIR_LABELS[pair]) << ": ";
+                    _json_counters(output, statistics.pairs[pair]);
+                }
+                output << "}}\n";
+            }
+
+            for (auto &[seconds, iteration, working_time] : _anytime)
+            {
+                output << "{\"type\": \"anytime\", \"elapsed\": " << seconds
+                       << ", \"iteration\": " << iteration
+                       << ", \"working_time\": " << working_time
+                       << "}\n";
+            }
+
+            if constexpr (utils::AllocationTracker::enabled)
+            {
+                for (auto &[zone, counters] : utils::AllocationTracker::zones())
+                {
+                    _json_allocations(output, zone, counters);
+                }
+                _json_allocations(output, "total", utils::AllocationTracker::total());
+            }
+
+            output.close();
+            if (!output)
+            {
+                throw std::runtime_error(utils::format("Unable to write \"%s\"", path.c_str()));
+            }
+        }
+
+        static TraceRecord::metrics_t _metrics(const std::shared_ptr<ST> &ptr)
+        {
+            return {ptr->cost().value, ptr->working_time, ptr->drone_energy_violation, ptr->capacity_violation, ptr->waiting_time_violation, ptr->fixed_time_violation};
+        }
 
     public:
         std::size_t last_improved = 0, iterations = 0;
+
+        // Lower bound on the optimal working time, 0 if not computed (see `d2d::LowerBound`)
+        double lower_bound = 0;
         std::chrono::milliseconds elapsed;
 
         void log(
@@ -24,6 +310,11 @@ namespace d2d
             const std::vector<std::shared_ptr<ST>> &elite_set,
             const std::pair<std::string, std::vector<std::size_t>> &neighborhood)
         {
+            if (_trace != nullptr)
+            {
+                return; // Superseded by the streaming trace
+            }
+
             _history.push_back(history);
             _progress.push_back(progress);
             _coefficients.push_back(ST::penalty_coefficients());
@@ -31,6 +322,128 @@ namespace d2d
             _neighborhoods.push_back(neighborhood);
         }
 
+        /**
+         * @brief Stream a compact record of every subsequent search step to a file.
+         *
+         * This replaces the in-memory history of `log`, and ancestors are no longer kept alive
+         * through `ParentInfo`, so that memory does not grow with the number of iterations.
+         *
+         * @param path The trace file path
+         */
+        void open_trace(const std::string &path)
+        {
+            _trace = std::make_unique<TraceWriter>(path);
+            ParentInfo<ST>::keep_lineage = false;
+        }
+
+        /**
+         * @brief Open the results file of `finalize` before the search, so that an unwritable path
+         * is reported up front instead of after the whole run.
+         *
+         * @param path The JSON lines output path
+         */
+        void open_output(const std::string &path)
+        {
+            _output.open(path);
+            if (!_output)
+            {
+                throw std::runtime_error(utils::format("Unable to open \"%s\" for writing", path.c_str()));
+            }
+        }
+
+        bool tracing() const
+        {
+            return _trace != nullptr;
+        }
+
+        /** @brief Accumulate the counters of a neighborhood, merging neighborhoods with the same label */
+        void add_statistics(const std::string &label, const NeighborhoodStatistics &statistics)
+        {
+            auto iter = std::find_if(
+                _statistics.begin(), _statistics.end(),
+                [&label](const std::pair<std::string, NeighborhoodStatistics> &p)
+                { return p.first == label; });
+            if (iter == _statistics.end())
+            {
+                _statistics.emplace_back(label, statistics);
+            }
+            else
+            {
+                iter->second += statistics;
+            }
+        }
+
+        /**
+         * @brief Record the anytime profile of the search: the wall-clock time (since the logger
+         * was constructed) and iteration at which the best feasible working time improved.
+         *
+         * @param iteration The iteration index
+         * @param ptr The new best solution, ignored if infeasible or not better than the last one
+         */
+        void improve(const std::size_t &iteration, const std::shared_ptr<ST> &ptr)
+        {
+            if (!ptr->feasible || (!_anytime.empty() && ptr->working_time >= std::get<2>(_anytime.back())))
+            {
+                return;
+            }
+
+            _anytime.emplace_back(
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count(),
+                iteration,
+                ptr->working_time);
+        }
+
+        /**
+         * @brief Record a search step to the trace file, if any.
+         *
+         * @param iteration The iteration index
+         * @param phase A string literal describing the search phase
+         * @param result The best solution so far
+         * @param current The current solution
+         * @param elite_set The elite set
+         * @param neighborhood The neighborhood label
+         * @param tabu The tabu attributes of the last move
+         */
+        void trace(
+            const std::size_t &iteration,
+            const char *phase,
+            const std::shared_ptr<ST> &result,
+            const std::shared_ptr<ST> &current,
+            const std::vector<std::shared_ptr<ST>> &elite_set,
+            const std::string &neighborhood,
+            const std::vector<std::size_t> &tabu)
+        {
+            if (_trace == nullptr)
+            {
+                return;
+            }
+
+            TraceRecord record;
+            record.iteration = iteration;
+            record.phase = phase;
+
+            auto length = std::min(neighborhood.size(), TraceRecord::MAX_LABEL - 1);
+            std::copy(neighborhood.begin(), neighborhood.begin() + length, record.neighborhood);
+            record.neighborhood[length] = '\0';
+
+            record.result = _metrics(result);
+            record.result_feasible = result->feasible;
+            record.current = _metrics(current);
+            record.current_feasible = current->feasible;
+            record.coefficients = ST::penalty_coefficients();
+
+            record.tabu_count = tabu.size();
+            std::copy(tabu.begin(), tabu.begin() + std::min(tabu.size(), TraceRecord::MAX_TABU), record.tabu.begin());
+
+            record.elite_count = elite_set.size();
+            for (std::size_t i = 0; i < std::min(elite_set.size(), TraceRecord::MAX_ELITE); i++)
+            {
+                record.elite[i] = elite_set[i]->working_time;
+            }
+
+            _trace->push(record);
+        }
+
         void print_solution(std::shared_ptr<ST> ptr)
         {
             if (ptr == nullptr)
@@ -46,19 +459,42 @@ namespace d2d
             std::cout << ptr->waiting_time_violation << "\n";
             std::cout << ptr->fixed_time_violation << "\n";
 
-            std::cout << ptr->truck_routes << "\n";
-            std::cout << ptr->drone_routes << "\n";
+            std::cout << ptr->truck_routes() << "\n";
+            std::cout << ptr->drone_routes() << "\n";
 
             std::cout << ptr->feasible << "\n";
-            std::cout << ptr->truck_working_time << "\n";
-            std::cout << ptr->drone_working_time << "\n";
+            std::cout << ptr->truck_working_time() << "\n";
+            std::cout << ptr->drone_working_time() << "\n";
         }
 
-        void finalize(const std::shared_ptr<ST> ptr)
+        /**
+         * @brief Report the result, either to the file of `open_output` or to stdout.
+         *
+         * @return Whether the result was written
+         */
+        bool finalize(const std::shared_ptr<ST> ptr)
         {
+            auto problem = d2d::Problem::get_instance();
+            _report_statistics();
+            _report_allocations();
+
+            if (!problem->output_path.empty())
+            {
+                try
+                {
+                    _write_json_lines(ptr, problem->output_path);
+                }
+                catch (const std::exception &e)
+                {
+                    std::cerr << e.what() << std::endl;
+                    return false;
+                }
+
+                return true;
+            }
+
             std::cout << std::fixed << std::setprecision(6);
 
-            auto problem = d2d::Problem::get_instance();
             std::cout << iterations << "\n";
 
             std::cout << problem->tabu_size_factor << "\n";
@@ -69,29 +505,7 @@ namespace d2d
             std::cout << problem->max_elite_size << "\n";
             std::cout << problem->destroy_rate << "\n";
 
-            if (problem->linear != nullptr)
-            {
-                std::cout << "linear\n";
-            }
-            else if (problem->nonlinear != nullptr)
-            {
-                std::cout << "nonlinear\n";
-            }
-            else if (problem->endurance != nullptr)
-            {
-                if (problem->endurance->fixed_time == 1e9)
-                {
-                    std::cout << "unlimited\n";
-                }
-                else
-                {
-                    std::cout << "endurance\n";
-                }
-            }
-            else
-            {
-                throw std::runtime_error("No drone configuration was found. This should never happen.");
-            }
+            std::cout << _config_label() << "\n";
 
             std::cout << (problem->drone->speed_type == d2d::StatsType::low ? "low" : "high") << "\n";
             std::cout << (problem->drone->range_type == d2d::StatsType::low ? "low" : "high") << "\n";
@@ -164,6 +578,7 @@ namespace d2d
 
             std::cout << elapsed.count() << "\n";
             std::cout << problem->strategy << "\n";
+            return true;
         }
     };
 }
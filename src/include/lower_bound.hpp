@@ -0,0 +1,483 @@
+#pragma once
+
+#include "problem.hpp"
+
+namespace d2d
+{
+    /**
+     * @brief Lower bounds on the working time (makespan) of any feasible solution of the current problem.
+     *
+     * Every bound relaxes the time-of-day truck speeds (trucks always move at their top speed) and the
+     * waiting time limit: a leg from `u` to `v` takes at least the service time of `u` plus the travel
+     * time at top speed (plus takeoff and landing for drones), and the working time of a vehicle is the
+     * sum of its legs. Routes are closed walks from the depot, so a vehicle serving a set of customers
+     * works at least as long as the shortest closed walk(s) through them.
+     */
+    class LowerBound
+    {
+    private:
+        static constexpr double INF = std::numeric_limits<double>::infinity();
+
+        /** @brief The minimum time of a truck (`drone == false`) or drone leg from `u` to `v` */
+        static double _leg(const bool &drone, const std::size_t &u, const std::size_t &v)
+        {
+            auto problem = Problem::get_instance();
+            if (drone)
+            {
+                return problem->columns.drone_service_time[u] +
+                       problem->drone->takeoff_time() +
+                       problem->drone->cruise_time(problem->distances[u][v]) +
+                       problem->drone->landing_time();
+            }
+
+            return problem->columns.truck_service_time[u] + problem->truck_distance(u, v) / problem->truck->top_speed();
+        }
+
+        /**
+         * @brief Shortest leg times from the depot to every customer (or from every customer to the
+         * depot if `reverse`), with a dense Dijkstra's algorithm.
+         */
+        static std::vector<double> _shortest_paths(const bool &drone, const bool &reverse)
+        {
+            const auto n = Problem::get_instance()->customers.size();
+            std::vector<double> result(n, INF);
+            std::vector<bool> done(n);
+
+            result[0] = 0;
+            for (std::size_t iteration = 0; iteration < n; iteration++)
+            {
+                std::size_t u = n;
+                for (std::size_t i = 0; i < n; i++)
+                {
+                    if (!done[i] && (u == n || result[i] < result[u]))
+                    {
+                        u = i;
+                    }
+                }
+
+                done[u] = true;
+                for (std::size_t v = 0; v < n; v++)
+                {
+                    if (!done[v])
+                    {
+                        result[v] = std::min(result[v], result[u] + (reverse ? _leg(drone, v, u) : _leg(drone, u, v)));
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        /** @brief Energy of the drone trip depot -> `customer` -> depot, as in `DroneRoute` */
+        static double _round_trip_energy(const std::size_t &customer)
+        {
+            auto problem = Problem::get_instance();
+            auto drone = problem->drone;
+
+            double energy = 0, weight = 0;
+            const std::size_t trip[] = {0, customer, 0};
+            for (std::size_t i = 0; i < 2; i++)
+            {
+                weight += problem->columns.demand[trip[i]];
+                energy += drone->takeoff_time() * drone->takeoff_power(weight) +
+                          drone->cruise_time(problem->distances[trip[i]][trip[i + 1]]) * drone->cruise_power(weight) +
+                          drone->landing_time() * drone->landing_power(weight);
+            }
+
+            return energy;
+        }
+
+        /**
+         * @brief Minimum cruise power of a drone carrying at most its capacity, with a ternary search since
+         * the power is convex in the weight for both drone models
+         */
+        static double _minimum_cruise_power()
+        {
+            auto drone = Problem::get_instance()->drone;
+
+            double low = 0, high = drone->capacity;
+            for (std::size_t iteration = 0; iteration < 100; iteration++)
+            {
+                const auto first = low + (high - low) / 3, second = high - (high - low) / 3;
+                if (drone->cruise_power(first) < drone->cruise_power(second))
+                {
+                    high = second;
+                }
+                else
+                {
+                    low = first;
+                }
+            }
+
+            return drone->cruise_power(low);
+        }
+
+        /**
+         * @brief Minimum makespan when each customer `c` is split (fractionally) between trucks, adding
+         * `truck[c]` to their total working time, and drones, adding `drone[c]`.
+         */
+        static double _split(const std::vector<double> &truck, const std::vector<double> &drone)
+        {
+            auto problem = Problem::get_instance();
+            const double trucks_count = problem->trucks_count, drones_count = problem->drones_count;
+
+            // Truck-only customers first, then by increasing truck/drone time ratio
+            std::vector<std::size_t> order;
+            std::vector<double> ratio(truck.size());
+            double forced_drone = 0, high = 0;
+            for (std::size_t c = 1; c < truck.size(); c++)
+            {
+                if (std::isfinite(truck[c]))
+                {
+                    order.push_back(c);
+                    ratio[c] = std::isfinite(drone[c]) ? truck[c] / drone[c] : -1;
+                    high += truck[c];
+                }
+                else if (std::isfinite(drone[c]))
+                {
+                    forced_drone += drone[c];
+                    high += drone[c];
+                }
+            }
+
+            std::sort(
+                order.begin(), order.end(),
+                [&ratio](const std::size_t &first, const std::size_t &second)
+                {
+                    return ratio[first] < ratio[second];
+                });
+
+            // Whether a makespan of `makespan` is achievable, filling the trucks in this order
+            const auto feasible = [&](const double &makespan)
+            {
+                double truck_budget = trucks_count * makespan, drone_load = forced_drone;
+                for (auto c : order)
+                {
+                    const auto fraction = truck[c] > 0 ? std::clamp(truck_budget / truck[c], 0.0, 1.0) : 1.0;
+                    truck_budget -= fraction * truck[c];
+                    if (fraction < 1)
+                    {
+                        drone_load += (1 - fraction) * drone[c];
+                    }
+                }
+
+                return drone_load <= drones_count * makespan;
+            };
+
+            // A makespan equal to the total work is always achievable
+            double low = 0;
+            for (std::size_t iteration = 0; iteration < 100; iteration++)
+            {
+                const auto middle = (low + high) / 2;
+                (feasible(middle) ? high : low) = middle;
+            }
+
+            return low;
+        }
+
+        /**
+         * @brief Minimum makespan of each customer subset partitioned among `count` identical vehicles,
+         * given the minimum working time `trips[S]` of a vehicle serving the customer subset `S`.
+         */
+        static std::vector<double> _partition(const std::vector<double> &trips, const std::size_t &count, const std::size_t &n)
+        {
+            std::vector<double> result(trips.size(), INF);
+            result[0] = 0;
+            if (count == 0)
+            {
+                return result;
+            }
+
+            result = trips;
+            for (std::size_t k = 1; k < std::min(count, n); k++)
+            {
+                auto next = result;
+                for (std::size_t mask = 1; mask < trips.size(); mask++)
+                {
+                    // Only subsets containing the lowest customer of `mask`, vehicles are identical
+                    const auto low = mask & (~mask + 1), rest = mask ^ low;
+                    for (std::size_t sub = rest;; sub = (sub - 1) & rest)
+                    {
+                        const auto first = sub | low;
+                        next[mask] = std::min(next[mask], std::max(trips[first], result[mask ^ first]));
+                        if (sub == 0)
+                        {
+                            break;
+                        }
+                    }
+                }
+
+                result = std::move(next);
+            }
+
+            return result;
+        }
+
+        /**
+         * @brief Minimum working time of a vehicle serving each customer subset, over all partitions of the
+         * subset into routes within the vehicle capacity (and for drones, into servable customers and
+         * routes within the fixed time limit).
+         */
+        static std::vector<double> _trips(const bool &drone, const std::vector<bool> &servable)
+        {
+            auto problem = Problem::get_instance();
+            const auto n = problem->customers.size() - 1;
+            const auto capacity = drone ? problem->drone->capacity : problem->truck->capacity;
+            const auto fixed_time = drone && problem->endurance != nullptr ? problem->endurance->fixed_time : INF;
+
+            // Shortest leg times between all pairs, walks may pass through other customers or the depot
+            std::vector<std::vector<double>> closure(n + 1, std::vector<double>(n + 1));
+            for (std::size_t u = 0; u <= n; u++)
+            {
+                for (std::size_t v = 0; v <= n; v++)
+                {
+                    closure[u][v] = u == v ? 0 : _leg(drone, u, v);
+                }
+            }
+
+            for (std::size_t w = 0; w <= n; w++)
+            {
+                for (std::size_t u = 0; u <= n; u++)
+                {
+                    for (std::size_t v = 0; v <= n; v++)
+                    {
+                        closure[u][v] = std::min(closure[u][v], closure[u][w] + closure[w][v]);
+                    }
+                }
+            }
+
+            // Held-Karp: shortest walk from the depot visiting the subset and ending at a customer
+            const std::size_t subsets = std::size_t(1) << n;
+            std::vector<std::vector<double>> walk(subsets, std::vector<double>(n, INF));
+            std::vector<double> routes(subsets, INF), demand(subsets);
+            routes[0] = 0;
+            for (std::size_t mask = 1; mask < subsets; mask++)
+            {
+                bool allowed = true;
+                for (std::size_t j = 0; j < n; j++)
+                {
+                    if (mask & (std::size_t(1) << j))
+                    {
+                        demand[mask] = demand[mask ^ (std::size_t(1) << j)] + problem->columns.demand[j + 1];
+                        allowed = allowed && servable[j + 1];
+
+                        const auto previous = mask ^ (std::size_t(1) << j);
+                        if (previous == 0)
+                        {
+                            walk[mask][j] = closure[0][j + 1];
+                        }
+                        else
+                        {
+                            for (std::size_t i = 0; i < n; i++)
+                            {
+                                if (previous & (std::size_t(1) << i))
+                                {
+                                    walk[mask][j] = std::min(walk[mask][j], walk[previous][i] + closure[i + 1][j + 1]);
+                                }
+                            }
+                        }
+                    }
+                }
+
+                if (allowed && demand[mask] <= capacity + TOLERANCE)
+                {
+                    for (std::size_t j = 0; j < n; j++)
+                    {
+                        routes[mask] = std::min(routes[mask], walk[mask][j] + closure[j + 1][0]);
+                    }
+
+                    if (routes[mask] > fixed_time + TOLERANCE)
+                    {
+                        routes[mask] = INF;
+                    }
+                }
+            }
+
+            // Multiple trips of the same vehicle
+            std::vector<double> result(subsets, INF);
+            result[0] = 0;
+            for (std::size_t mask = 1; mask < subsets; mask++)
+            {
+                const auto low = mask & (~mask + 1), rest = mask ^ low;
+                for (std::size_t sub = rest;; sub = (sub - 1) & rest)
+                {
+                    const auto first = sub | low;
+                    result[mask] = std::min(result[mask], routes[first] + result[mask ^ first]);
+                    if (sub == 0)
+                    {
+                        break;
+                    }
+                }
+            }
+
+            return result;
+        }
+
+    public:
+        /** @brief The largest number of customers for which the exact subset bound is computed */
+        static constexpr std::size_t EXACT_CUSTOMERS = 12;
+
+        /** @brief Each customer must be visited by the shortest closed walk of a vehicle able to serve it */
+        double round_trip = 0;
+
+        /**
+         * @brief The total working time of each vehicle type is at least the sum, over its customers, of
+         * the shortest leg into each customer, plus a share of the shortest return to the depot
+         * proportional to the customer demand over the vehicle capacity (each route carries at most
+         * the capacity). Customers are split fractionally between trucks and drones.
+         */
+        double relaxation = 0;
+
+        /**
+         * @brief Exact makespan of the relaxed problem (Held-Karp tours, multiple trips within the
+         * vehicle capacity and partition among vehicles), 0 if there are more than `EXACT_CUSTOMERS`
+         * customers.
+         */
+        double exact = 0;
+
+        /**
+         * @brief As `relaxation`, with the number of drone routes bounded by the battery instead of the
+         * capacity: every drone leg into a customer takes at least the energy of the shortest one at the
+         * lowest powers, each route also needs a leg back to the depot, and no route uses more than the
+         * battery. The share of the return legs of each customer is then its leg energy over the battery
+         * left by a return leg. 0 without a battery.
+         */
+        double energy = 0;
+
+        LowerBound()
+        {
+            auto problem = Problem::get_instance();
+            const auto n = problem->customers.size() - 1;
+            const auto truck_to = _shortest_paths(false, false), truck_from = _shortest_paths(false, true),
+                       drone_to = _shortest_paths(true, false), drone_from = _shortest_paths(true, true);
+
+            // Customers that a drone can serve without exceeding its battery or fixed time limit on its own
+            double battery = INF;
+            if (problem->linear != nullptr)
+            {
+                battery = problem->linear->battery;
+            }
+            else if (problem->nonlinear != nullptr)
+            {
+                battery = problem->nonlinear->battery;
+            }
+
+            std::vector<bool> servable(n + 1);
+            for (std::size_t c = 1; c <= n; c++)
+            {
+                servable[c] = problem->drones_count > 0 &&
+                              problem->columns.dronable[c] &&
+                              _round_trip_energy(c) <= battery + TOLERANCE &&
+                              (problem->endurance == nullptr || drone_to[c] + drone_from[c] <= problem->endurance->fixed_time + TOLERANCE);
+            }
+
+            std::vector<double> truck(n + 1, INF), drone(n + 1, INF), drone_legs(n + 1, INF);
+            double truck_return = INF, drone_return = INF;
+            for (std::size_t c = 1; c <= n; c++)
+            {
+                truck_return = std::min(truck_return, _leg(false, c, 0));
+                drone_return = std::min(drone_return, _leg(true, c, 0));
+            }
+
+            for (std::size_t c = 1; c <= n; c++)
+            {
+                double truck_in = INF, drone_in = INF;
+                for (std::size_t u = 0; u <= n; u++)
+                {
+                    if (u != c)
+                    {
+                        truck_in = std::min(truck_in, _leg(false, u, c));
+                        drone_in = std::min(drone_in, _leg(true, u, c));
+                    }
+                }
+
+                double best = INF;
+                if (problem->trucks_count > 0)
+                {
+                    truck[c] = truck_in + problem->columns.demand[c] / problem->truck->capacity * truck_return;
+                    best = truck_to[c] + truck_from[c];
+                }
+                if (servable[c])
+                {
+                    drone_legs[c] = drone_in;
+                    drone[c] = drone_in + problem->columns.demand[c] / problem->drone->capacity * drone_return;
+                    best = std::min(best, drone_to[c] + drone_from[c]);
+                }
+
+                // Ignore customers that cannot be served at all, no solution is feasible anyway
+                if (std::isfinite(best))
+                {
+                    round_trip = std::max(round_trip, best);
+                }
+            }
+
+            relaxation = _split(truck, drone);
+
+            if (std::isfinite(battery) && problem->drones_count > 0)
+            {
+                // Lowest energy of a drone leg of the given distance, takeoff and landing powers increase with the weight
+                const auto drone_config = problem->drone;
+                const auto cruise_power = _minimum_cruise_power();
+                const auto leg_energy = [&drone_config, &cruise_power](const double &distance)
+                {
+                    return drone_config->takeoff_time() * drone_config->takeoff_power(0) +
+                           drone_config->cruise_time(distance) * cruise_power +
+                           drone_config->landing_time() * drone_config->landing_power(0);
+                };
+
+                std::vector<double> energy_in(n + 1, INF);
+                double return_energy = INF;
+                for (std::size_t c = 1; c <= n; c++)
+                {
+                    for (std::size_t u = 0; u <= n; u++)
+                    {
+                        if (u != c)
+                        {
+                            energy_in[c] = std::min(energy_in[c], leg_energy(problem->distances[u][c]));
+                        }
+                    }
+
+                    return_energy = std::min(return_energy, leg_energy(problem->distances[c][0]));
+                }
+
+                if (battery > return_energy)
+                {
+                    std::vector<double> drone_by_energy(n + 1, INF);
+                    for (std::size_t c = 1; c <= n; c++)
+                    {
+                        if (servable[c])
+                        {
+                            drone_by_energy[c] = drone_legs[c] + energy_in[c] / (battery - return_energy) * drone_return;
+                        }
+                    }
+
+                    energy = _split(truck, drone_by_energy);
+                }
+            }
+
+            if (n > 0 && n <= EXACT_CUSTOMERS)
+            {
+                const auto full = (std::size_t(1) << n) - 1;
+                const auto trucks = _partition(_trips(false, std::vector<bool>(n + 1, true)), problem->trucks_count, n),
+                           drones = _partition(_trips(true, servable), problem->drones_count, n);
+
+                exact = INF;
+                for (std::size_t mask = 0; mask <= full; mask++)
+                {
+                    exact = std::min(exact, std::max(trucks[mask], drones[full ^ mask]));
+                }
+
+                if (!std::isfinite(exact))
+                {
+                    exact = 0;
+                }
+            }
+        }
+
+        /** @brief The best of all bounds */
+        double value() const
+        {
+            return std::max({round_trip, relaxation, exact, energy});
+        }
+    };
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "format.hpp"
+
+namespace utils
+{
+    /**
+     * @brief A read-only view of a whole file mapped into memory.
+     *
+     * The file content is exposed without copying through `data()` and `view()`, and stays valid
+     * for the lifetime of this object.
+     */
+    class MappedFile
+    {
+    private:
+        const char *_data = nullptr;
+        std::size_t _size = 0;
+
+#if defined(WIN32)
+        HANDLE _file = INVALID_HANDLE_VALUE;
+        HANDLE _mapping = nullptr;
+#endif
+
+        void _release()
+        {
+#if defined(WIN32)
+            if (_data != nullptr)
+            {
+                UnmapViewOfFile(_data);
+            }
+            if (_mapping != nullptr)
+            {
+                CloseHandle(_mapping);
+            }
+            if (_file != INVALID_HANDLE_VALUE)
+            {
+                CloseHandle(_file);
+            }
+
+            _file = INVALID_HANDLE_VALUE;
+            _mapping = nullptr;
+#elif defined(__linux__)
+            if (_data != nullptr)
+            {
+                munmap(const_cast<char *>(_data), _size);
+            }
+#endif
+
+            _data = nullptr;
+            _size = 0;
+        }
+
+    public:
+        /**
+         * @brief Map a file into memory.
+         *
+         * @param path The path to the file
+         * @note `std::runtime_error` is thrown if the file cannot be opened or mapped.
+         */
+        MappedFile(const std::string &path)
+        {
+#if defined(WIN32)
+            _file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (_file == INVALID_HANDLE_VALUE)
+            {
+                throw std::runtime_error(format("Unable to open \"%s\"", path.c_str()));
+            }
+
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(_file, &size))
+            {
+                _release();
+                throw std::runtime_error(format("Unable to get the size of \"%s\"", path.c_str()));
+            }
+
+            _size = size.QuadPart;
+            if (_size > 0)
+            {
+                _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (_mapping == nullptr)
+                {
+                    _release();
+                    throw std::runtime_error(format("Unable to map \"%s\"", path.c_str()));
+                }
+
+                _data = static_cast<const char *>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+                if (_data == nullptr)
+                {
+                    _release();
+                    throw std::runtime_error(format("Unable to map \"%s\"", path.c_str()));
+                }
+            }
+#elif defined(__linux__)
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd == -1)
+            {
+                throw std::runtime_error(format("Unable to open \"%s\"", path.c_str()));
+            }
+
+            struct stat info;
+            if (fstat(fd, &info) == -1)
+            {
+                close(fd);
+                throw std::runtime_error(format("Unable to get the size of \"%s\"", path.c_str()));
+            }
+
+            _size = info.st_size;
+            if (_size > 0)
+            {
+                void *address = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (address == MAP_FAILED)
+                {
+                    close(fd);
+                    throw std::runtime_error(format("Unable to map \"%s\"", path.c_str()));
+                }
+
+                _data = static_cast<const char *>(address);
+            }
+
+            close(fd); // The mapping remains valid after closing the file descriptor
+#else
+            throw std::runtime_error("Unsupported platform");
+#endif
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        ~MappedFile()
+        {
+            _release();
+        }
+
+        /** @brief A pointer to the beginning of the mapped content */
+        const char *data() const
+        {
+            return _data;
+        }
+
+        /** @brief The size of the mapped content in bytes */
+        std::size_t size() const
+        {
+            return _size;
+        }
+
+        /** @brief A view of the whole mapped content */
+        std::string_view view() const
+        {
+            return std::string_view(_data, _size);
+        }
+    };
+}
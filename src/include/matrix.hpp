@@ -0,0 +1,76 @@
+#pragma once
+
+#include "mapped_file.hpp"
+
+namespace utils
+{
+    /**
+     * @brief A square matrix stored contiguously in row-major order.
+     *
+     * The storage is either owned by the matrix or borrowed from a memory-mapped file, which is then
+     * kept alive as long as the matrix (or any of its copies). Copies share the same storage.
+     *
+     * @tparam T An arithmetic type
+     */
+    template <typename T, std::enable_if_t<std::is_arithmetic_v<T>, bool> = true>
+    class SquareMatrix
+    {
+    private:
+        std::size_t _size;
+        std::shared_ptr<T[]> _data;
+
+        /** @brief The number of elements of a matrix with `size` rows, checked against overflow */
+        static std::size_t _elements(const std::size_t &size)
+        {
+            if (size != 0 && size > std::numeric_limits<std::size_t>::max() / sizeof(T) / size)
+            {
+                throw std::length_error("Matrix size overflows the address space");
+            }
+
+            return size * size;
+        }
+
+    public:
+        /** @brief Construct a zero-filled matrix owning its storage */
+        SquareMatrix(const std::size_t &size) : _size(size), _data(new T[_elements(size)]()) {}
+
+        /**
+         * @brief Construct a read-only matrix whose storage lives inside a memory-mapped file.
+         *
+         * @param size The number of rows (and columns)
+         * @param file The mapped file
+         * @param offset The byte offset of the first element, must be suitably aligned for `T`
+         */
+        SquareMatrix(const std::size_t &size, const std::shared_ptr<MappedFile> &file, const std::size_t &offset)
+            : _size(size),
+              _data(file, reinterpret_cast<T *>(const_cast<char *>(file->data() + offset)))
+        {
+            if (offset % alignof(T) != 0 || offset > file->size() ||
+                (size != 0 && size > (file->size() - offset) / sizeof(T) / size))
+            {
+                throw std::out_of_range("Matrix does not fit inside the mapped file");
+            }
+        }
+
+        std::size_t size() const
+        {
+            return _size;
+        }
+
+        const T *data() const
+        {
+            return _data.get();
+        }
+
+        /** @brief A pointer to the beginning of a row. Must not be used to write to a mapped matrix. */
+        T *operator[](const std::size_t &row)
+        {
+            return _data.get() + row * _size;
+        }
+
+        const T *operator[](const std::size_t &row) const
+        {
+            return _data.get() + row * _size;
+        }
+    };
+}
@@ -1,45 +1,372 @@
 #pragma once
 
+#include "../instrument.hpp"
 #include "../parent.hpp"
+#include "../pool.hpp"
 #include "../problem.hpp"
 #include "../routes.hpp"
+#include "statistics.hpp"
 
 namespace d2d
 {
+    /**
+     * @brief Type-erased aspiration criteria passed to the virtual `BaseNeighborhood::move`. The scans
+     * themselves are templates called with a concrete callable, see `CRTPNeighborhood`.
+     *
+     * This is a non-owning reference: the underlying callable must outlive the call it is passed to.
+     */
+    template <typename ST>
+    using aspiration_criteria_t = utils::FunctionRef<bool(const std::shared_ptr<ST> &)>;
+
+    /** @brief Whether `_AC` can be used as the aspiration criteria of a neighborhood over `ST` */
+    template <typename _AC, typename ST>
+    constexpr bool is_aspiration_criteria_v = std::is_invocable_r_v<bool, const _AC &, const std::shared_ptr<ST> &>;
+
+    /** @brief Which scans `BaseNeighborhood::move` runs, and how much of the neighborhood they explore */
+    struct ScanPolicy
+    {
+        enum Scope
+        {
+            /** @brief Both scans, as a move of tabu search */
+            ALL,
+
+            /** @brief Only the intra-route scan */
+            INTRA_ROUTE,
+
+            /** @brief Only the inter-route scan */
+            INTER_ROUTE,
+        };
+
+        Scope scope = ALL;
+
+        enum Mode
+        {
+            /** @brief Evaluate every candidate and return the best one */
+            BEST,
+
+            /**
+             * @brief Stop at the first accepted candidate improving the current solution, visiting
+             * vehicle pairs in random order
+             */
+            FIRST,
+
+            /** @brief Evaluate a random fraction of the candidates and return the best one */
+            SAMPLED,
+        };
+
+        Mode mode = BEST;
+
+        /** @brief Probability of evaluating each candidate in `SAMPLED` mode */
+        double sample_rate = 1.0;
+
+        /**
+         * @brief Vehicles (trucks first, then drones) that every inter-route move must modify at least
+         * one of, e.g. the critical vehicles of the makespan. Empty to search all vehicle pairs.
+         */
+        std::vector<bool> focus;
+    };
+
+    /**
+     * @brief The candidates for which the aspiration criteria of the following neighborhood scans may
+     * hold. Candidates outside these bounds that cannot be accepted by the scan either are rejected
+     * before they are constructed (see `BaseNeighborhood::set_pruning`), and the aspiration criteria
+     * are not called for the constructed ones outside them.
+     */
+    struct Pruning
+    {
+        /** @brief Whether the aspiration criteria only hold for feasible candidates */
+        bool feasible_only = false;
+
+        /** @brief The aspiration criteria only hold for candidates with a lower cost */
+        double max_cost = std::numeric_limits<double>::infinity();
+    };
+
+    /** @brief Working time and constraint violations of the routes of one vehicle, see `Solution::evaluate_vehicle` */
+    struct VehicleEvaluation
+    {
+        double working_time = 0;
+        double energy_violation = 0;
+        double capacity_violation = 0;
+        double waiting_time_violation = 0;
+        double fixed_time_violation = 0;
+    };
+
     /**
      * @brief Base class for local search neighborhoods
      */
     template <typename ST>
     class BaseNeighborhood
     {
-    public:
-        virtual std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> intra_route(
-            const std::shared_ptr<ST> solution,
-            const std::function<bool(std::shared_ptr<ST>)> &aspiration_criteria) = 0;
+    protected:
+        NeighborhoodStatistics _statistics;
 
-        virtual std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> inter_route(
+        // Pair index (see `NeighborhoodStatistics`) of the moves currently being generated
+        std::size_t _pair = 0;
+
+        // Pair index of the move that last replaced the best candidate
+        std::size_t _best_pair = 0;
+
+        // Bounds of the candidates the aspiration criteria may hold for
+        Pruning _pruning;
+
+        template <typename... RTs>
+        void _set_pair()
+        {
+            _pair = NeighborhoodStatistics::pair_index<RTs...>();
+        }
+
+        /** @brief Capacity violation of a route of type `RT` carrying `weight`, as in `RT::capacity_violation` */
+        template <typename RT, std::enable_if_t<is_route_v<RT>, bool> = true>
+        static double _capacity_violation(const double &weight)
+        {
+            auto problem = Problem::get_instance();
+            if constexpr (std::is_same_v<RT, TruckRoute>)
+            {
+                return std::max(0.0, weight - problem->truck->capacity);
+            }
+            else
+            {
+                return std::max(0.0, weight - problem->drone->capacity);
+            }
+        }
+
+        /**
+         * @brief Lower bound of the working time of a candidate: the maximum working time of the
+         * vehicles (trucks first, then drones) whose routes are not modified
+         */
+        static double _working_time_bound(const std::shared_ptr<ST> &solution, const std::initializer_list<std::size_t> &modified)
+        {
+            const auto trucks_count = solution->truck_working_time().size();
+            const auto unmodified = [&modified](const std::size_t &vehicle)
+            {
+                return std::find(modified.begin(), modified.end(), vehicle) == modified.end();
+            };
+
+            double result = 0;
+            for (std::size_t i = 0; i < trucks_count; i++)
+            {
+                if (unmodified(i))
+                {
+                    result = std::max(result, solution->truck_working_time()[i]);
+                }
+            }
+            for (std::size_t i = 0; i < solution->drone_working_time().size(); i++)
+            {
+                if (unmodified(trucks_count + i))
+                {
+                    result = std::max(result, solution->drone_working_time()[i]);
+                }
+            }
+
+            return result;
+        }
+
+        /** @brief Lower bound of the cost of a candidate, since every penalty is non-negative */
+        static double _cost_bound(const double &working_time, const double &capacity_violation)
+        {
+            return working_time + ST::penalty_coefficients()[1] * capacity_violation;
+        }
+
+        /**
+         * @brief Whether the aspiration criteria may hold for a candidate, according to the bounds given
+         * by `set_pruning`
+         *
+         * @param working_time A lower bound of the working time of the candidate
+         * @param capacity_violation The capacity violation of the candidate
+         */
+        bool _aspirable(const double &working_time, const double &capacity_violation) const
+        {
+            if (_pruning.feasible_only)
+            {
+                // The cost of a feasible candidate is its working time
+                return utils::approximate(capacity_violation, 0.0) && working_time + TOLERANCE < _pruning.max_cost;
+            }
+
+            return _cost_bound(working_time, capacity_violation) + TOLERANCE < _pruning.max_cost;
+        }
+
+        /** @brief Whether the aspiration criteria may hold for a constructed candidate, see `_aspirable` above */
+        bool _aspirable(const std::shared_ptr<ST> &candidate) const
+        {
+            return (candidate->feasible || !_pruning.feasible_only) && candidate->cost() < _pruning.max_cost;
+        }
+
+        /**
+         * @brief Whether to reject candidates before constructing them. Without a tabu list, a candidate
+         * is only accepted if the aspiration criteria hold.
+         *
+         * @param candidates The number of candidates sharing these bounds
+         */
+        bool _prune(const double &working_time, const double &capacity_violation, const std::uint64_t &candidates = 1)
+        {
+            if (_aspirable(working_time, capacity_violation))
+            {
+                return false;
+            }
+
+            _statistics.pairs[_pair].pruned += candidates;
+            return true;
+        }
+
+        /**
+         * @brief Acceptance test of neighborhoods without a tabu list: the candidate must satisfy
+         * the aspiration criteria and be better than the best candidate so far.
+         */
+        template <typename _AC, std::enable_if_t<is_aspiration_criteria_v<_AC, ST>, bool> = true>
+        bool _accept(
+            const std::shared_ptr<ST> &candidate,
+            const _AC &aspiration_criteria,
+            const std::shared_ptr<ST> &result)
+        {
+            auto &counters = _statistics.pairs[_pair];
+            counters.evaluated++;
+            counters.feasible += candidate->feasible;
+
+            if (!aspiration_criteria(candidate))
+            {
+                return false;
+            }
+
+            counters.aspiration_hits++;
+            if (result == nullptr || candidate->cost() < result->cost())
+            {
+                _best_pair = _pair;
+                return true;
+            }
+
+            return false;
+        }
+
+        /**
+         * @brief Run the scans selected by `policy`. In a move of tabu search, the inter-route scan is
+         * skipped once the search runs out of time or is interrupted.
+         *
+         * @return The best candidate accepted by the scans, its tabu attributes and its pair index
+         */
+        template <typename _IntraRoute, typename _InterRoute>
+        std::tuple<std::shared_ptr<ST>, std::vector<std::size_t>, std::size_t> _scan(
+            const ScanPolicy &policy,
+            const _IntraRoute &intra_route,
+            const _InterRoute &inter_route)
+        {
+            std::shared_ptr<ST> result;
+            std::vector<std::size_t> tabu;
+            std::size_t pair = 0;
+
+            const auto update = [this, &result, &tabu, &pair](const std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> &r)
+            {
+                if (r.first != nullptr && (result == nullptr || r.first->cost() < result->cost()))
+                {
+                    result = r.first;
+                    tabu = r.second;
+                    pair = _best_pair;
+                }
+            };
+
+            const auto scan_intra_route = [&]()
+            {
+                if (policy.scope != ScanPolicy::INTER_ROUTE)
+                {
+                    utils::InstrumentZone _intra(utils::Instrumentation::DETAILS, "neighborhood", "intra_route");
+                    update(intra_route());
+                }
+            };
+            const auto scan_inter_route = [&]()
+            {
+                if (policy.scope == ScanPolicy::INTER_ROUTE || (policy.scope == ScanPolicy::ALL && !Problem::get_instance()->search_stopped()))
+                {
+                    utils::InstrumentZone _inter(utils::Instrumentation::DETAILS, "neighborhood", "inter_route");
+                    update(inter_route());
+                }
+            };
+
+            // With first-improvement, either scan may come first so that neither is favored
+            if (policy.mode == ScanPolicy::FIRST && utils::random<int>(0, 1) == 1)
+            {
+                scan_inter_route();
+                scan_intra_route();
+            }
+            else
+            {
+                scan_intra_route();
+                scan_inter_route();
+            }
+
+            return std::make_tuple(result, tabu, pair);
+        }
+
+    public:
+        /**
+         * @brief Perform a local search to find the best solution in the neighborhood. This is the only
+         * virtual entry point of a neighborhood, see `CRTPNeighborhood`.
+         *
+         * @param solution A shared pointer to the current solution
+         * @param aspiration_criteria The aspiration criteria of the search. This function should return
+         * `true` if the solution satisfies the aspiration criteria, `false` otherwise. It is only called
+         * for the candidates it may hold for according to `set_pruning`.
+         * @param policy Which scans to run and how much of the neighborhood they explore
+         * @return The best solution found that is not `solution`, or `nullptr` if no candidate was accepted
+         */
+        virtual std::shared_ptr<ST> move(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(std::shared_ptr<ST>)> &aspiration_criteria) = 0;
+            const aspiration_criteria_t<ST> &aspiration_criteria,
+            const ScanPolicy &policy) = 0;
 
         virtual std::string label() const = 0;
 
         virtual std::shared_ptr<ST> construct(
             const std::shared_ptr<ParentInfo<ST>> parent,
             const std::vector<std::vector<TruckRoute>> &truck_routes,
-            const std::vector<std::vector<DroneRoute>> &drone_routes) const final
+            const std::vector<std::vector<DroneRoute>> &drone_routes) final
         {
-            return std::make_shared<ST>(truck_routes, drone_routes, parent);
+            _statistics.pairs[_pair].generated++;
+            return ST::create(truck_routes, drone_routes, parent);
         }
 
         virtual std::shared_ptr<ParentInfo<ST>> parent_ptr(const std::shared_ptr<ST> solution) const final
         {
-            return std::make_shared<ParentInfo<ST>>(solution, label());
+            return std::allocate_shared<ParentInfo<ST>>(utils::PoolAllocator<ParentInfo<ST>>(), solution, label());
+        }
+
+        /**
+         * @brief Set the bounds of the candidates the aspiration criteria of the following scans may
+         * hold for, so that cheap bound checks reject the others before they are constructed. The
+         * default bounds never reject a candidate.
+         *
+         * Pruning is disabled when destroy and repair is enabled: every feasible candidate constructed
+         * lowers `ST::best_with_edges`, which destroy and repair scores customers with, and whether a
+         * rejected candidate is feasible is only known once it is constructed.
+         */
+        void set_pruning(const Pruning &pruning)
+        {
+            _pruning = Problem::get_instance()->destroy_rate > 0 ? Pruning() : pruning;
+        }
+
+        const NeighborhoodStatistics &statistics() const
+        {
+            return _statistics;
+        }
+
+        NeighborhoodStatistics &statistics()
+        {
+            return _statistics;
         }
     };
 
     template <typename ST, bool _EnableTabuList>
     class Neighborhood : public BaseNeighborhood<ST>
     {
+    protected:
+        /** @brief Run the scans of `move`, see `BaseNeighborhood::_scan` */
+        template <typename _IntraRoute, typename _InterRoute>
+        std::shared_ptr<ST> _move(
+            const std::shared_ptr<ST> &solution,
+            const ScanPolicy &policy,
+            const _IntraRoute &intra_route,
+            const _InterRoute &inter_route)
+        {
+            return std::get<0>(this->_scan(policy, intra_route, inter_route));
+        }
     };
 
     template <typename ST>
@@ -54,6 +381,162 @@ namespace d2d
 
         static const std::vector<std::size_t> _empty_tabu_id;
 
+        // Scan policy of the ongoing `move` call (best-improvement outside of it)
+        ScanPolicy _policy;
+
+        // Whether an accepted candidate improved the current solution during the ongoing scan
+        bool _improved = false;
+
+    protected:
+        /** @brief Whether the scan policy skips the next candidate, checked before constructing it */
+        bool _skip() const
+        {
+            switch (_policy.mode)
+            {
+            case ScanPolicy::FIRST:
+                return _improved;
+            case ScanPolicy::SAMPLED:
+                return utils::random(0.0, 1.0) >= _policy.sample_rate;
+            default:
+                return false;
+            }
+        }
+
+        /**
+         * @brief Whether the scan searches inter-route moves between two vehicles (trucks first, then
+         * drones): one of them must be focused by the scan policy
+         */
+        bool _focused(const std::size_t &vehicle_i, const std::size_t &vehicle_j) const
+        {
+            return _policy.focus.empty() || _policy.focus[vehicle_i] || _policy.focus[vehicle_j];
+        }
+
+        /**
+         * @brief The pairs of vehicles (trucks first, then drones) to search for inter-route moves, in
+         * random order unless the scan policy is best-improvement
+         *
+         * @param symmetric Whether a pair and its reverse give the same moves, in which case only
+         * pairs with `vehicle_i <= vehicle_j` are listed
+         */
+        std::vector<std::pair<std::size_t, std::size_t>> _vehicle_pairs(const bool symmetric) const
+        {
+            auto problem = Problem::get_instance();
+            auto vehicles_count = problem->trucks_count + problem->drones_count;
+
+            std::vector<std::pair<std::size_t, std::size_t>> pairs;
+            for (std::size_t vehicle_i = 0; vehicle_i < vehicles_count; vehicle_i++)
+            {
+                for (std::size_t vehicle_j = (symmetric ? vehicle_i : 0); vehicle_j < vehicles_count; vehicle_j++)
+                {
+                    if (_focused(vehicle_i, vehicle_j))
+                    {
+                        pairs.emplace_back(vehicle_i, vehicle_j);
+                    }
+                }
+            }
+
+            if (_policy.mode != ScanPolicy::BEST)
+            {
+                std::shuffle(pairs.begin(), pairs.end(), utils::rng);
+            }
+
+            return pairs;
+        }
+
+        /**
+         * @brief Whether to reject a candidate before constructing it: the aspiration criteria cannot
+         * hold for it and it cannot be better than the best candidate so far
+         *
+         * @param working_time A lower bound of the working time of the candidate
+         * @param capacity_violation The capacity violation of the candidate
+         */
+        bool _prune(const double &working_time, const double &capacity_violation, const std::shared_ptr<ST> &result)
+        {
+            if (result == nullptr ||
+                this->_aspirable(working_time, capacity_violation) ||
+                this->_cost_bound(working_time, capacity_violation) + TOLERANCE < result->cost().value)
+            {
+                return false;
+            }
+
+            this->_statistics.pairs[this->_pair].pruned++;
+            return true;
+        }
+
+        /**
+         * @brief Acceptance test of tabu search: the candidate must differ in cost from the current
+         * solution, satisfy the aspiration criteria or not be tabu, and be better than the best
+         * candidate so far.
+         *
+         * @param is_tabu A callable returning whether the move is tabu, only invoked when the
+         * aspiration criteria is not satisfied
+         */
+        template <typename _AC, typename _IsTabu, std::enable_if_t<is_aspiration_criteria_v<_AC, ST> && std::is_invocable_r_v<bool, const _IsTabu &>, bool> = true>
+        bool _accept(
+            const std::shared_ptr<ST> &solution,
+            const std::shared_ptr<ST> &candidate,
+            const _AC &aspiration_criteria,
+            const _IsTabu &is_tabu,
+            const std::shared_ptr<ST> &result)
+        {
+            if (solution->cost() == candidate->cost())
+            {
+                return false;
+            }
+
+            auto &counters = this->_statistics.pairs[this->_pair];
+            counters.evaluated++;
+            counters.feasible += candidate->feasible;
+
+            if (aspiration_criteria(candidate))
+            {
+                counters.aspiration_hits++;
+            }
+            else if (is_tabu())
+            {
+                counters.tabu_rejected++;
+                return false;
+            }
+
+            if (result == nullptr || candidate->cost() < result->cost())
+            {
+                this->_best_pair = this->_pair;
+                _improved = _improved || candidate->cost() < solution->cost();
+                return true;
+            }
+
+            return false;
+        }
+
+        /**
+         * @brief Evaluate the candidate given by the temporarily modified routes and make it the best
+         * candidate so far if `_accept` holds
+         */
+        template <typename _AC, std::enable_if_t<is_aspiration_criteria_v<_AC, ST>, bool> = true>
+        void _evaluate(
+            const std::shared_ptr<ST> &solution,
+            const std::shared_ptr<ParentInfo<ST>> &parent,
+            const std::vector<std::vector<TruckRoute>> &truck_routes,
+            const std::vector<std::vector<DroneRoute>> &drone_routes,
+            std::vector<std::size_t> &new_tabu,
+            const _AC &aspiration_criteria,
+            std::shared_ptr<ST> &result,
+            std::vector<std::size_t> &tabu)
+        {
+            auto new_solution = this->construct(parent, truck_routes, drone_routes);
+            if (_accept(
+                    solution,
+                    new_solution,
+                    aspiration_criteria,
+                    [&]
+                    { return this->is_tabu(new_tabu); },
+                    result))
+            {
+                result = new_solution;
+                tabu = new_tabu;
+            }
+        }
+
     public:
         const std::vector<std::size_t> &last_tabu() const
         {
@@ -113,40 +596,32 @@ namespace d2d
             _tabu_list.clear();
         }
 
+    protected:
         /**
-         * @brief Perform a local search to find the best solution in the neighborhood.
-         *
-         * @param solution A shared pointer to the current solution
-         * @param aspiration_criteria The aspiration criteria of tabu search. This function should return `true`
-         * if the solution satisfies the aspiration criteria, `false` otherwise
-         * @return The best solution found that is not `solution`, or `nullptr` if the neighborhood is empty
+         * @brief Run the scans of `move`, see `BaseNeighborhood::_scan`. The candidate returned by a
+         * move of tabu search (`ScanPolicy::ALL`) is made tabu and counted as a win of its pair.
          */
-        std::shared_ptr<ST> move(
-            const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria)
+        template <typename _IntraRoute, typename _InterRoute>
+        std::shared_ptr<ST> _move(
+            const std::shared_ptr<ST> &solution,
+            const ScanPolicy &policy,
+            const _IntraRoute &intra_route,
+            const _InterRoute &inter_route)
         {
-#ifdef DEBUG
-            utils::PerformanceBenchmark _perf(this->label());
-#endif
-
-            std::shared_ptr<ST> result;
-            std::vector<std::size_t> tabu;
+            _policy = policy;
+            _improved = false;
 
-            const auto update = [&result, &tabu](const std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> &r)
-            {
-                if (r.first != nullptr && (result == nullptr || r.first->cost() < result->cost()))
-                {
-                    result = r.first;
-                    tabu = r.second;
-                }
-            };
+            auto [result, tabu, pair] = this->_scan(policy, intra_route, inter_route);
 
-            update(this->intra_route(solution, aspiration_criteria));
-            update(this->inter_route(solution, aspiration_criteria));
+            _policy = ScanPolicy();
 
-            if (result != nullptr)
+            if (result != nullptr && policy.scope == ScanPolicy::ALL)
             {
                 this->add_to_tabu(tabu);
+
+                auto &counters = this->_statistics.pairs[pair];
+                counters.wins++;
+                counters.improvement += solution->cost().value - result->cost().value;
             }
 
             return result;
@@ -155,4 +630,48 @@ namespace d2d
 
     template <typename ST>
     const std::vector<std::size_t> Neighborhood<ST, true>::_empty_tabu_id;
+
+    /**
+     * @brief Implements the virtual `move` of the neighborhood `_Derived` with its non-virtual scan
+     * templates `intra_route` and `inter_route`. The scans are instantiated with a concrete callable
+     * that checks the bounds given by `set_pruning` inline, so that the type-erased aspiration
+     * criteria are only called for the candidates they may hold for.
+     */
+    template <typename ST, bool _EnableTabuList, typename _Derived>
+    class CRTPNeighborhood : public Neighborhood<ST, _EnableTabuList>
+    {
+    public:
+        std::shared_ptr<ST> move(
+            const std::shared_ptr<ST> solution,
+            const aspiration_criteria_t<ST> &aspiration_criteria,
+            const ScanPolicy &policy) override
+        {
+            // The single scans of post-optimization are recorded in zones of their own
+            std::optional<utils::InstrumentZone> _zone;
+            if (policy.scope == ScanPolicy::ALL)
+            {
+                _zone.emplace(utils::Instrumentation::NEIGHBORHOODS, "neighborhood", [this]
+                              { return this->label(); });
+            }
+
+            auto start = std::chrono::steady_clock::now();
+
+            const auto criteria = [this, &aspiration_criteria](const std::shared_ptr<ST> &candidate)
+            {
+                return this->_aspirable(candidate) && aspiration_criteria(candidate);
+            };
+
+            auto &derived = static_cast<_Derived &>(*this);
+            auto result = this->_move(
+                solution,
+                policy,
+                [&]()
+                { return derived.intra_route(solution, criteria); },
+                [&]()
+                { return derived.inter_route(solution, criteria); });
+
+            this->_statistics.elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return result;
+        }
+    };
 }
@@ -5,13 +5,13 @@
 namespace d2d
 {
     template <typename ST>
-    class CrossExchange : public Neighborhood<ST, false>
+    class CrossExchange : public CRTPNeighborhood<ST, false, CrossExchange<ST>>
     {
     private:
-        template <typename _RT_I, typename _RT_J, std::enable_if_t<is_route_v<_RT_I, _RT_J>, bool> = true>
+        template <typename _RT_I, typename _RT_J, typename _AC, std::enable_if_t<is_route_v<_RT_I, _RT_J> && is_aspiration_criteria_v<_AC, ST>, bool> = true>
         void _inter_route_internal(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria,
+            const _AC &aspiration_criteria,
             const std::shared_ptr<ParentInfo<ST>> parent,
             std::shared_ptr<ST> &result,
             std::vector<std::vector<TruckRoute>> &truck_routes,
@@ -20,15 +20,17 @@ namespace d2d
             const std::size_t &vehicle_j)
         {
             auto problem = Problem::get_instance();
+            this->template _set_pair<_RT_I, _RT_J>();
 
             std::size_t _vehicle_i = utils::ternary<std::is_same_v<_RT_I, TruckRoute>>(vehicle_i, vehicle_i - problem->trucks_count);
             std::size_t _vehicle_j = utils::ternary<std::is_same_v<_RT_J, TruckRoute>>(vehicle_j, vehicle_j - problem->trucks_count);
 
             auto &vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(truck_routes, drone_routes);
             auto &vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(truck_routes, drone_routes);
-            auto &original_vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(solution->truck_routes, solution->drone_routes);
-            auto &original_vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(solution->truck_routes, solution->drone_routes);
+            auto &original_vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(solution->truck_routes(), solution->drone_routes());
+            auto &original_vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(solution->truck_routes(), solution->drone_routes());
 
+            const auto working_time = this->_working_time_bound(solution, {vehicle_i, vehicle_j});
             for (std::size_t route_i = 0; route_i < original_vehicle_routes_i[_vehicle_i].size(); route_i++)
             {
                 for (std::size_t route_j = 0; route_j < original_vehicle_routes_j[_vehicle_j].size(); route_j++)
@@ -42,8 +44,14 @@ namespace d2d
                         }
                     }
 
-                    const auto &customers_i = original_vehicle_routes_i[_vehicle_i][route_i].customers();
-                    const auto &customers_j = original_vehicle_routes_j[_vehicle_j][route_j].customers();
+                    const auto &original_i = original_vehicle_routes_i[_vehicle_i][route_i];
+                    const auto &original_j = original_vehicle_routes_j[_vehicle_j][route_j];
+                    const auto &customers_i = original_i.customers();
+                    const auto &customers_j = original_j.customers();
+                    const auto &aggregates_i = original_i.aggregates(), &aggregates_j = original_j.aggregates();
+
+                    // Capacity violation of the unmodified routes
+                    const auto capacity_violation = solution->capacity_violation - original_i.capacity_violation() - original_j.capacity_violation();
 
                     for (std::size_t i = 1; i < customers_i.size(); i++)
                     {
@@ -51,30 +59,36 @@ namespace d2d
                         {
                             if constexpr (std::is_same_v<_RT_I, TruckRoute> && std::is_same_v<_RT_J, DroneRoute>)
                             {
-                                if (std::any_of(
-                                        customers_i.begin() + i, customers_i.begin() + ix,
-                                        [&problem](const std::size_t &c)
-                                        { return !problem->customers[c].dronable; }))
+                                if (!aggregates_i.dronable(i, ix))
                                 {
                                     continue;
                                 }
                             }
 
+                            const auto demand_i = aggregates_i.demand(i, ix);
                             for (std::size_t j = 1; j < customers_j.size(); j++)
                             {
                                 for (std::size_t jx = j; jx < customers_j.size(); jx++)
                                 {
                                     if constexpr (std::is_same_v<_RT_J, TruckRoute> && std::is_same_v<_RT_I, DroneRoute>)
                                     {
-                                        if (std::any_of(
-                                                customers_j.begin() + j, customers_j.begin() + jx,
-                                                [&problem](const std::size_t &c)
-                                                { return !problem->customers[c].dronable; }))
+                                        if (!aggregates_j.dronable(j, jx))
                                         {
                                             continue;
                                         }
                                     }
 
+                                    // Most candidates overload a route, reject them before building any vector
+                                    const auto demand_j = aggregates_j.demand(j, jx);
+                                    if (this->_prune(
+                                            working_time,
+                                            capacity_violation +
+                                                this->template _capacity_violation<_RT_I>(original_i.weight() - demand_i + demand_j) +
+                                                this->template _capacity_violation<_RT_J>(original_j.weight() - demand_j + demand_i)))
+                                    {
+                                        continue;
+                                    }
+
                                     /* Swap [i, ix) of route_i and [j, jx) of route_j */
                                     std::vector<std::size_t> ri(customers_i.begin(), customers_i.begin() + i);
                                     std::vector<std::size_t> rj(customers_j.begin(), customers_j.begin() + j);
@@ -104,7 +118,7 @@ namespace d2d
                                     }
 
                                     auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                                    if (aspiration_criteria(new_solution) && (result == nullptr || new_solution->cost() < result->cost()))
+                                    if (this->_accept(new_solution, aspiration_criteria, result))
                                     {
                                         result = new_solution;
                                     }
@@ -129,23 +143,25 @@ namespace d2d
             return "CROSS-exchange";
         }
 
+        template <typename _AC, std::enable_if_t<is_aspiration_criteria_v<_AC, ST>, bool> = true>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> intra_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AC &aspiration_criteria)
         {
             return std::make_pair(nullptr, std::vector<std::size_t>());
         }
 
+        template <typename _AC, std::enable_if_t<is_aspiration_criteria_v<_AC, ST>, bool> = true>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> inter_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AC &aspiration_criteria)
         {
             auto problem = Problem::get_instance();
             auto parent = this->parent_ptr(solution);
             std::shared_ptr<ST> result;
 
-            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes);
-            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes);
+            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes());
+            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes());
 
             for (std::size_t vehicle_i = 0; vehicle_i < problem->trucks_count + problem->drones_count; vehicle_i++)
             {
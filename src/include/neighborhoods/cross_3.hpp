@@ -5,13 +5,13 @@
 namespace d2d
 {
     template <typename ST>
-    class CrossExchange_3 : public Neighborhood<ST, false>
+    class CrossExchange_3 : public CRTPNeighborhood<ST, false, CrossExchange_3<ST>>
     {
     private:
-        template <typename _RT_I, typename _RT_J, typename _RT_K, std::enable_if_t<is_route_v<_RT_I, _RT_J, _RT_K>, bool> = true>
+        template <typename _RT_I, typename _RT_J, typename _RT_K, typename _AC, std::enable_if_t<is_route_v<_RT_I, _RT_J, _RT_K> && is_aspiration_criteria_v<_AC, ST>, bool> = true>
         void _inter_route_internal(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria,
+            const _AC &aspiration_criteria,
             const std::shared_ptr<ParentInfo<ST>> parent,
             std::shared_ptr<ST> &result,
             std::vector<std::vector<TruckRoute>> &truck_routes,
@@ -21,6 +21,7 @@ namespace d2d
             const std::size_t &vehicle_k)
         {
             auto problem = Problem::get_instance();
+            this->template _set_pair<_RT_I, _RT_J, _RT_K>();
 
             std::size_t _vehicle_i = utils::ternary<std::is_same_v<_RT_I, TruckRoute>>(vehicle_i, vehicle_i - problem->trucks_count);
             std::size_t _vehicle_j = utils::ternary<std::is_same_v<_RT_J, TruckRoute>>(vehicle_j, vehicle_j - problem->trucks_count);
@@ -30,10 +31,11 @@ namespace d2d
             auto &vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(truck_routes, drone_routes);
             auto &vehicle_routes_k = utils::match_type<std::vector<std::vector<_RT_K>>>(truck_routes, drone_routes);
 
-            auto &original_vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(solution->truck_routes, solution->drone_routes);
-            auto &original_vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(solution->truck_routes, solution->drone_routes);
-            auto &original_vehicle_routes_k = utils::match_type<std::vector<std::vector<_RT_K>>>(solution->truck_routes, solution->drone_routes);
+            auto &original_vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(solution->truck_routes(), solution->drone_routes());
+            auto &original_vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(solution->truck_routes(), solution->drone_routes());
+            auto &original_vehicle_routes_k = utils::match_type<std::vector<std::vector<_RT_K>>>(solution->truck_routes(), solution->drone_routes());
 
+            const auto working_time = this->_working_time_bound(solution, {vehicle_i, vehicle_j, vehicle_k});
             for (std::size_t route_i = 0; route_i < original_vehicle_routes_i[_vehicle_i].size(); route_i++)
             {
                 for (std::size_t route_j = 0; route_j < original_vehicle_routes_j[_vehicle_j].size(); route_j++)
@@ -58,9 +60,21 @@ namespace d2d
                             }
                         }
 
-                        const auto &customers_i = original_vehicle_routes_i[_vehicle_i][route_i].customers();
-                        const auto &customers_j = original_vehicle_routes_j[_vehicle_j][route_j].customers();
-                        const auto &customers_k = original_vehicle_routes_k[_vehicle_k][route_k].customers();
+                        const auto &original_i = original_vehicle_routes_i[_vehicle_i][route_i];
+                        const auto &original_j = original_vehicle_routes_j[_vehicle_j][route_j];
+                        const auto &original_k = original_vehicle_routes_k[_vehicle_k][route_k];
+                        const auto &customers_i = original_i.customers();
+                        const auto &customers_j = original_j.customers();
+                        const auto &customers_k = original_k.customers();
+                        const auto &aggregates_i = original_i.aggregates(),
+                                   &aggregates_j = original_j.aggregates(),
+                                   &aggregates_k = original_k.aggregates();
+
+                        // Capacity violation of the unmodified routes
+                        const auto capacity_violation = solution->capacity_violation -
+                                                        original_i.capacity_violation() -
+                                                        original_j.capacity_violation() -
+                                                        original_k.capacity_violation();
 
                         for (std::size_t i = 1; i < customers_i.size(); i++)
                         {
@@ -68,34 +82,49 @@ namespace d2d
                             {
                                 if constexpr (std::is_same_v<_RT_I, TruckRoute> && std::is_same_v<_RT_J, DroneRoute>)
                                 {
-                                    if (std::any_of(
-                                            customers_i.begin() + i, customers_i.begin() + ix,
-                                            [&problem](const std::size_t &c)
-                                            { return !problem->customers[c].dronable; }))
+                                    if (!aggregates_i.dronable(i, ix))
                                     {
                                         continue;
                                     }
                                 }
 
+                                const auto demand_i = aggregates_i.demand(i, ix);
                                 for (std::size_t j = 1; j < customers_j.size(); j++)
                                 {
                                     for (std::size_t jx = j; jx < customers_j.size(); jx++)
                                     {
+                                        // A single call may overrun the time limit on its own, so it stops with the best
+                                        // candidate so far once the limit is reached or a stop is requested
+                                        if (problem->stopped())
+                                        {
+                                            return;
+                                        }
+
                                         if constexpr (std::is_same_v<_RT_J, TruckRoute> && std::is_same_v<_RT_K, DroneRoute>)
                                         {
-                                            if (std::any_of(
-                                                    customers_j.begin() + j, customers_j.begin() + jx,
-                                                    [&problem](const std::size_t &c)
-                                                    { return !problem->customers[c].dronable; }))
+                                            if (!aggregates_j.dronable(j, jx))
                                             {
                                                 continue;
                                             }
                                         }
 
+                                        const auto demand_j = aggregates_j.demand(j, jx);
                                         for (std::size_t k = 1; k < customers_k.size(); k++)
                                         {
                                             for (std::size_t kx = k; kx < customers_k.size(); kx++)
                                             {
+                                                // Most candidates overload a route, reject them before building any vector
+                                                const auto demand_k = aggregates_k.demand(k, kx);
+                                                if (this->_prune(
+                                                        working_time,
+                                                        capacity_violation +
+                                                            this->template _capacity_violation<_RT_I>(original_i.weight() - demand_i + demand_k) +
+                                                            this->template _capacity_violation<_RT_J>(original_j.weight() - demand_j + demand_i) +
+                                                            this->template _capacity_violation<_RT_K>(original_k.weight() - demand_k + demand_j)))
+                                                {
+                                                    continue;
+                                                }
+
                                                 /* Swap [i, ix) of route_i, [j, jx) of route_j and [k, kx) of route_k (forward) */
                                                 std::vector<std::size_t> ri(customers_i.begin(), customers_i.begin() + i);
                                                 std::vector<std::size_t> rj(customers_j.begin(), customers_j.begin() + j);
@@ -136,7 +165,7 @@ namespace d2d
                                                 }
 
                                                 auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                                                if (aspiration_criteria(new_solution) && (result == nullptr || new_solution->cost() < result->cost()))
+                                                if (this->_accept(new_solution, aspiration_criteria, result))
                                                 {
                                                     result = new_solution;
                                                 }
@@ -168,23 +197,25 @@ namespace d2d
             return "CROSS-exchange 3";
         }
 
+        template <typename _AC, std::enable_if_t<is_aspiration_criteria_v<_AC, ST>, bool> = true>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> intra_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AC &aspiration_criteria)
         {
             return std::make_pair(nullptr, std::vector<std::size_t>());
         }
 
+        template <typename _AC, std::enable_if_t<is_aspiration_criteria_v<_AC, ST>, bool> = true>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> inter_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AC &aspiration_criteria)
         {
             auto problem = Problem::get_instance();
             auto parent = this->parent_ptr(solution);
             std::shared_ptr<ST> result;
 
-            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes);
-            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes);
+            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes());
+            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes());
 
             for (std::size_t vehicle_i = 0; vehicle_i < problem->trucks_count + problem->drones_count; vehicle_i++)
             {
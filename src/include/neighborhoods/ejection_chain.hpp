@@ -5,13 +5,13 @@
 namespace d2d
 {
     template <typename ST>
-    class EjectionChain : public Neighborhood<ST, false>
+    class EjectionChain : public CRTPNeighborhood<ST, false, EjectionChain<ST>>
     {
     private:
-        template <typename _RT_I, typename _RT_J, typename _RT_K, std::enable_if_t<is_route_v<_RT_I, _RT_J, _RT_K>, bool> = true>
+        template <typename _RT_I, typename _RT_J, typename _RT_K, typename _AC, std::enable_if_t<is_route_v<_RT_I, _RT_J, _RT_K> && is_aspiration_criteria_v<_AC, ST>, bool> = true>
         void _inter_route_internal(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria,
+            const _AC &aspiration_criteria,
             const std::shared_ptr<ParentInfo<ST>> parent,
             std::shared_ptr<ST> &result,
             std::vector<std::vector<TruckRoute>> &truck_routes,
@@ -21,6 +21,7 @@ namespace d2d
             const std::size_t &vehicle_k)
         {
             auto problem = Problem::get_instance();
+            this->template _set_pair<_RT_I, _RT_J, _RT_K>();
 
             std::size_t _vehicle_i = utils::ternary<std::is_same_v<_RT_I, TruckRoute>>(vehicle_i, vehicle_i - problem->trucks_count);
             std::size_t _vehicle_j = utils::ternary<std::is_same_v<_RT_J, TruckRoute>>(vehicle_j, vehicle_j - problem->trucks_count);
@@ -30,23 +31,20 @@ namespace d2d
             auto &vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(truck_routes, drone_routes);
             auto &vehicle_routes_k = utils::match_type<std::vector<std::vector<_RT_K>>>(truck_routes, drone_routes);
 
-            auto &original_vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(solution->truck_routes, solution->drone_routes);
-            auto &original_vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(solution->truck_routes, solution->drone_routes);
-            auto &original_vehicle_routes_k = utils::match_type<std::vector<std::vector<_RT_K>>>(solution->truck_routes, solution->drone_routes);
-
-            // std::cerr << "\e[31mInitial state:" << std::endl;
-            // std::cerr << original_vehicle_routes_i << std::endl;
-            // std::cerr << original_vehicle_routes_j << std::endl;
-            // std::cerr << original_vehicle_routes_k << "\e[0m\n";
+            auto &original_vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(solution->truck_routes(), solution->drone_routes());
+            auto &original_vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(solution->truck_routes(), solution->drone_routes());
+            auto &original_vehicle_routes_k = utils::match_type<std::vector<std::vector<_RT_K>>>(solution->truck_routes(), solution->drone_routes());
 
+            const auto working_time = this->_working_time_bound(solution, {vehicle_i, vehicle_j, vehicle_k});
             for (std::size_t route_i = 0; route_i < original_vehicle_routes_i[_vehicle_i].size(); route_i++)
             {
-                const auto &customers_i = original_vehicle_routes_i[_vehicle_i][route_i].customers();
+                const auto &original_i = original_vehicle_routes_i[_vehicle_i][route_i];
+                const auto &customers_i = original_i.customers();
                 for (std::size_t i = 1; i + 1 < customers_i.size(); i++)
                 {
                     if constexpr (std::is_same_v<_RT_I, TruckRoute> && std::is_same_v<_RT_J, DroneRoute>)
                     {
-                        if (!problem->customers[customers_i[i]].dronable)
+                        if (!problem->columns.dronable[customers_i[i]])
                         {
                             continue;
                         }
@@ -62,9 +60,17 @@ namespace d2d
                             }
                         }
 
-                        const auto &customers_j = original_vehicle_routes_j[_vehicle_j][route_j].customers();
+                        const auto &original_j = original_vehicle_routes_j[_vehicle_j][route_j];
+                        const auto &customers_j = original_j.customers();
                         for (std::size_t jx = 1; jx < customers_j.size(); jx++)
                         {
+                            // A single call may overrun the time limit on its own, so it stops with the best
+                            // candidate so far once the limit is reached or a stop is requested
+                            if (problem->stopped())
+                            {
+                                return;
+                            }
+
                             for (std::size_t jy = 1; jy < customers_j.size(); jy++) /* Inserting customers_i[i] to customers_j[jx] increases size by 1 */
                             {
                                 if (jx == jy) /* Route j is intact */
@@ -74,44 +80,66 @@ namespace d2d
 
                                 if constexpr (std::is_same_v<_RT_J, TruckRoute> && std::is_same_v<_RT_K, DroneRoute>)
                                 {
-                                    if (!problem->customers[customers_j[jy - (jy > jx)]].dronable)
+                                    if (!problem->columns.dronable[customers_j[jy - (jy > jx)]])
                                     {
                                         continue;
                                     }
                                 }
 
-                                /* Construct temporaries and temporary state lv1 */
-                                std::vector<std::size_t> ri(customers_i), rj(customers_j);
-                                ri.erase(ri.begin() + i);
-                                rj.insert(rj.begin() + jx, customers_i[i]);
-                                rj.erase(rj.begin() + jy);
-
                                 std::size_t insert_k = customers_j[jy - (jy > jx)];
-                                vehicle_routes_j[_vehicle_j][route_j] = _RT_J(rj);
-                                if (ri.size() == 2)
-                                {
-                                    vehicle_routes_i[_vehicle_i].erase(vehicle_routes_i[_vehicle_i].begin() + route_i);
-                                }
-                                else
+                                const bool ri_empty = (customers_i.size() == 3);
+
+                                // Capacity violation of the candidates without route k: the routes of vehicle_k
+                                // can only get heavier
+                                const auto demand_i = problem->columns.demand[customers_i[i]], demand_k = problem->columns.demand[insert_k];
+                                const auto capacity_violation = solution->capacity_violation -
+                                                                original_i.capacity_violation() -
+                                                                original_j.capacity_violation() +
+                                                                this->template _capacity_violation<_RT_I>(original_i.weight() - demand_i) +
+                                                                this->template _capacity_violation<_RT_J>(original_j.weight() + demand_i - demand_k);
+
+                                /* Construct temporaries and temporary state lv1, only when a candidate is not pruned */
+                                bool lv1 = false;
+                                const auto construct_lv1 = [&]()
                                 {
-                                    vehicle_routes_i[_vehicle_i][route_i] = _RT_I(ri);
-                                }
+                                    if (lv1)
+                                    {
+                                        return;
+                                    }
 
-                                // std::cerr << "Temporary state " << vehicle_routes_i << " " << vehicle_routes_j << ", insert_k = " << insert_k << std::endl;
+                                    lv1 = true;
+                                    std::vector<std::size_t> ri(customers_i), rj(customers_j);
+                                    ri.erase(ri.begin() + i);
+                                    rj.insert(rj.begin() + jx, customers_i[i]);
+                                    rj.erase(rj.begin() + jy);
 
-                                /* Construct a new route of vehicle_k (temporary state lv2) */
-                                vehicle_routes_k[_vehicle_k].emplace_back(std::vector<std::size_t>{0, insert_k, 0});
+                                    vehicle_routes_j[_vehicle_j][route_j] = _RT_J(rj);
+                                    if (ri_empty)
+                                    {
+                                        vehicle_routes_i[_vehicle_i].erase(vehicle_routes_i[_vehicle_i].begin() + route_i);
+                                    }
+                                    else
+                                    {
+                                        vehicle_routes_i[_vehicle_i][route_i] = _RT_I(ri);
+                                    }
+                                };
 
-                                auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                                if (aspiration_criteria(new_solution) && (result == nullptr || new_solution->cost() < result->cost()))
+                                /* Construct a new route of vehicle_k (temporary state lv2) */
+                                if (!this->_prune(working_time, capacity_violation + this->template _capacity_violation<_RT_K>(demand_k)))
                                 {
-                                    result = new_solution;
-                                }
+                                    construct_lv1();
+                                    vehicle_routes_k[_vehicle_k].emplace_back(std::vector<std::size_t>{0, insert_k, 0});
 
-                                /* Restore temporary state lv1 */
-                                vehicle_routes_k[_vehicle_k].pop_back();
+                                    auto new_solution = this->construct(parent, truck_routes, drone_routes);
+                                    if (this->_accept(new_solution, aspiration_criteria, result))
+                                    {
+                                        result = new_solution;
+                                    }
+
+                                    /* Restore temporary state lv1 */
+                                    vehicle_routes_k[_vehicle_k].pop_back();
+                                }
 
-                                // std::cerr << "1. Restore temporary state " << vehicle_routes_i << " " << vehicle_routes_j << std::endl;
                                 /* Swap customers between 3 existing routes */
                                 bool same_ik = (vehicle_i == vehicle_k);
                                 for (std::size_t route_k = 0; route_k < original_vehicle_routes_k[_vehicle_k].size() - same_ik; route_k++)
@@ -132,8 +160,21 @@ namespace d2d
                                         }
                                     }
 
-                                    std::size_t route_k_new = route_k - (ri.size() == 2 && same_ik && route_k >= route_i);
-                                    const auto &customers_k = original_vehicle_routes_k[_vehicle_k][route_k].customers();
+                                    // The insertion position in route k does not change the bounds
+                                    const auto &original_k = original_vehicle_routes_k[_vehicle_k][route_k];
+                                    const auto &customers_k = original_k.customers();
+                                    if (this->_prune(
+                                            working_time,
+                                            capacity_violation -
+                                                original_k.capacity_violation() +
+                                                this->template _capacity_violation<_RT_K>(original_k.weight() + demand_k),
+                                            customers_k.size() - 1))
+                                    {
+                                        continue;
+                                    }
+
+                                    construct_lv1();
+                                    std::size_t route_k_new = route_k - (ri_empty && same_ik && route_k >= route_i);
                                     for (std::size_t k = 1; k < customers_k.size(); k++)
                                     {
                                         /* Insert to position k */
@@ -143,26 +184,26 @@ namespace d2d
                                         /* Temporary modify (temporary state lv2) */
                                         vehicle_routes_k[_vehicle_k][route_k_new] = _RT_K(rk);
 
-                                        // std::cerr << "Constructing " << truck_routes << " " << drone_routes << std::endl;
                                         auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                                        if (aspiration_criteria(new_solution) && (result == nullptr || new_solution->cost() < result->cost()))
+                                        if (this->_accept(new_solution, aspiration_criteria, result))
                                         {
                                             result = new_solution;
                                         }
 
                                         /* Restore temporary state lv1 */
                                         vehicle_routes_k[_vehicle_k][route_k_new] = original_vehicle_routes_k[_vehicle_k][route_k];
-                                        // std::cerr << "2. Restore temporary state " << vehicle_routes_i << " " << vehicle_routes_j << std::endl;
                                     }
                                 }
 
                                 /* Restore */
-                                vehicle_routes_i[_vehicle_i] = original_vehicle_routes_i[_vehicle_i];
-                                if (vehicle_i != vehicle_j)
+                                if (lv1)
                                 {
-                                    vehicle_routes_j[_vehicle_j][route_j] = original_vehicle_routes_j[_vehicle_j][route_j];
+                                    vehicle_routes_i[_vehicle_i] = original_vehicle_routes_i[_vehicle_i];
+                                    if (vehicle_i != vehicle_j)
+                                    {
+                                        vehicle_routes_j[_vehicle_j][route_j] = original_vehicle_routes_j[_vehicle_j][route_j];
+                                    }
                                 }
-                                // std::cerr << "3. Restore original state " << vehicle_routes_i << " " << vehicle_routes_j << std::endl;
                             }
                         }
                     }
@@ -176,23 +217,25 @@ namespace d2d
             return "Ejection chain";
         }
 
+        template <typename _AC, std::enable_if_t<is_aspiration_criteria_v<_AC, ST>, bool> = true>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> intra_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AC &aspiration_criteria)
         {
             return std::make_pair(nullptr, std::vector<std::size_t>());
         }
 
+        template <typename _AC, std::enable_if_t<is_aspiration_criteria_v<_AC, ST>, bool> = true>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> inter_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AC &aspiration_criteria)
         {
             auto problem = Problem::get_instance();
             auto parent = this->parent_ptr(solution);
             std::shared_ptr<ST> result;
 
-            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes);
-            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes);
+            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes());
+            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes());
 
             for (std::size_t vehicle_i = 0; vehicle_i < problem->trucks_count + problem->drones_count; vehicle_i++)
             {
@@ -4,14 +4,17 @@
 
 namespace d2d
 {
+    template <typename ST, std::size_t X, std::size_t Y>
+    class MoveXY;
+
     template <typename ST, std::size_t X, std::size_t Y, std::enable_if_t<(X >= Y && X != 0), bool> = true>
-    class _BaseMoveXY : public Neighborhood<ST, true>
+    class _BaseMoveXY : public CRTPNeighborhood<ST, true, MoveXY<ST, X, Y>>
     {
     private:
-        template <typename _RT_I, typename _RT_J, std::enable_if_t<is_route_v<_RT_I, _RT_J>, bool> = true>
+        template <typename _RT_I, typename _RT_J, typename _AC, std::enable_if_t<is_route_v<_RT_I, _RT_J> && is_aspiration_criteria_v<_AC, ST>, bool> = true>
         void _inter_route_internal(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria,
+            const _AC &aspiration_criteria,
             const std::shared_ptr<ParentInfo<ST>> parent,
             std::shared_ptr<ST> &result,
             std::vector<std::size_t> &tabu,
@@ -21,25 +24,38 @@ namespace d2d
             const std::size_t &vehicle_j)
         {
             auto problem = Problem::get_instance();
+            this->template _set_pair<_RT_I, _RT_J>();
 
             std::size_t _vehicle_i = utils::ternary<std::is_same_v<_RT_I, TruckRoute>>(vehicle_i, vehicle_i - problem->trucks_count);
             std::size_t _vehicle_j = utils::ternary<std::is_same_v<_RT_J, TruckRoute>>(vehicle_j, vehicle_j - problem->trucks_count);
 
             auto &vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(truck_routes, drone_routes);
             auto &vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(truck_routes, drone_routes);
-            auto &original_vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(solution->truck_routes, solution->drone_routes);
-            auto &original_vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(solution->truck_routes, solution->drone_routes);
+            auto &original_vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(solution->truck_routes(), solution->drone_routes());
+            auto &original_vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(solution->truck_routes(), solution->drone_routes());
 
+            const auto working_time = this->_working_time_bound(solution, {vehicle_i, vehicle_j});
             for (std::size_t route_i = 0; route_i < original_vehicle_routes_i[_vehicle_i].size(); route_i++)
             {
                 for (std::size_t route_j = 0; route_j < original_vehicle_routes_j[_vehicle_j].size(); route_j++)
                 {
-                    const auto &customers_i = original_vehicle_routes_i[_vehicle_i][route_i].customers();
-                    const auto &customers_j = original_vehicle_routes_j[_vehicle_j][route_j].customers();
+                    const auto &original_i = original_vehicle_routes_i[_vehicle_i][route_i];
+                    const auto &original_j = original_vehicle_routes_j[_vehicle_j][route_j];
+                    const auto &customers_i = original_i.customers();
+                    const auto &customers_j = original_j.customers();
+                    const auto &aggregates_i = original_i.aggregates(), &aggregates_j = original_j.aggregates();
+
+                    // Capacity violation of the unmodified routes
+                    const auto capacity_violation = solution->capacity_violation - original_i.capacity_violation() - original_j.capacity_violation();
                     for (std::size_t i = 1; i + X < customers_i.size(); i++)
                     {
                         for (std::size_t j = 1; j + Y < customers_j.size(); j++)
                         {
+                            if (this->_skip())
+                            {
+                                continue;
+                            }
+
                             if constexpr (std::is_same_v<_RT_I, _RT_J>)
                             {
                                 if (_vehicle_i == _vehicle_j && route_i == route_j) /* same route */
@@ -48,23 +64,9 @@ namespace d2d
                                 }
                             }
 
-                            /* Swap [i, i + X) of route i and [j, j + Y) of route j */
-
-                            std::vector<std::size_t> ri(customers_i.begin(), customers_i.begin() + i);
-                            std::vector<std::size_t> rj(customers_j.begin(), customers_j.begin() + j);
-
-                            ri.insert(ri.end(), customers_j.begin() + j, customers_j.begin() + (j + Y));
-                            rj.insert(rj.end(), customers_i.begin() + i, customers_i.begin() + (i + X));
-
-                            ri.insert(ri.end(), customers_i.begin() + (i + X), customers_i.end());
-                            rj.insert(rj.end(), customers_j.begin() + (j + Y), customers_j.end());
-
                             if constexpr (std::is_same_v<_RT_I, DroneRoute> && std::is_same_v<_RT_J, TruckRoute>)
                             {
-                                if (std::any_of(
-                                        customers_j.begin() + j, customers_j.begin() + (j + Y),
-                                        [&problem](const std::size_t &c)
-                                        { return !problem->customers[c].dronable; }))
+                                if (!aggregates_j.dronable(j, j + Y))
                                 {
                                     continue;
                                 }
@@ -72,15 +74,34 @@ namespace d2d
 
                             if constexpr (std::is_same_v<_RT_I, TruckRoute> && std::is_same_v<_RT_J, DroneRoute>)
                             {
-                                if (std::any_of(
-                                        customers_i.begin() + i, customers_i.begin() + (i + X),
-                                        [&problem](const std::size_t &c)
-                                        { return !problem->customers[c].dronable; }))
+                                if (!aggregates_i.dronable(i, i + X))
                                 {
                                     continue;
                                 }
                             }
 
+                            const auto demand_i = aggregates_i.demand(i, i + X), demand_j = aggregates_j.demand(j, j + Y);
+                            if (this->_prune(
+                                    working_time,
+                                    capacity_violation +
+                                        this->template _capacity_violation<_RT_I>(original_i.weight() - demand_i + demand_j) +
+                                        this->template _capacity_violation<_RT_J>(original_j.weight() - demand_j + demand_i),
+                                    result))
+                            {
+                                continue;
+                            }
+
+                            /* Swap [i, i + X) of route i and [j, j + Y) of route j */
+
+                            std::vector<std::size_t> ri(customers_i.begin(), customers_i.begin() + i);
+                            std::vector<std::size_t> rj(customers_j.begin(), customers_j.begin() + j);
+
+                            ri.insert(ri.end(), customers_j.begin() + j, customers_j.begin() + (j + Y));
+                            rj.insert(rj.end(), customers_i.begin() + i, customers_i.begin() + (i + X));
+
+                            ri.insert(ri.end(), customers_i.begin() + (i + X), customers_i.end());
+                            rj.insert(rj.end(), customers_j.begin() + (j + Y), customers_j.end());
+
                             /* Temporary modify */
                             bool ri_empty = (ri.size() == 2), rj_empty = (rj.size() == 2); /* Note: At least 1 flag is false */
                             if (ri_empty)
@@ -102,14 +123,7 @@ namespace d2d
                             std::vector<std::size_t> new_tabu(customers_i.begin() + i, customers_i.begin() + (i + X));
                             new_tabu.insert(new_tabu.end(), customers_j.begin() + j, customers_j.begin() + (j + Y));
 
-                            auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                            if (solution->cost() != new_solution->cost() &&
-                                (aspiration_criteria(new_solution) || !this->is_tabu(new_tabu)) &&
-                                (result == nullptr || new_solution->cost() < result->cost()))
-                            {
-                                result = new_solution;
-                                tabu = new_tabu;
-                            }
+                            this->_evaluate(solution, parent, truck_routes, drone_routes, new_tabu, aspiration_criteria, result, tabu);
 
                             /* Restore */
                             vehicle_routes_i[_vehicle_i] = original_vehicle_routes_i[_vehicle_i];
@@ -120,10 +134,10 @@ namespace d2d
             }
         }
 
-        template <typename _RT_Src, std::enable_if_t<is_route_v<_RT_Src>, bool> = true>
+        template <typename _RT_Src, typename _AC, std::enable_if_t<is_route_v<_RT_Src> && is_aspiration_criteria_v<_AC, ST>, bool> = true>
         void _inter_route_append_internal(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria,
+            const _AC &aspiration_criteria,
             const std::shared_ptr<ParentInfo<ST>> parent,
             std::shared_ptr<ST> &result,
             std::vector<std::size_t> &tabu,
@@ -140,39 +154,45 @@ namespace d2d
             auto problem = Problem::get_instance();
 
             auto &vehicle_routes_src = utils::match_type<std::vector<std::vector<_RT_Src>>>(truck_routes, drone_routes);
-            auto &original_vehicle_routes_src = utils::match_type<std::vector<std::vector<_RT_Src>>>(solution->truck_routes, solution->drone_routes);
+            auto &original_vehicle_routes_src = utils::match_type<std::vector<std::vector<_RT_Src>>>(solution->truck_routes(), solution->drone_routes());
 
             for (std::size_t vehicle_src = 0; vehicle_src < original_vehicle_routes_src.size(); vehicle_src++)
             {
                 for (std::size_t route_src = 0; route_src < original_vehicle_routes_src[vehicle_src].size(); route_src++)
                 {
+                    const auto vehicle = utils::ternary<std::is_same_v<_RT_Src, TruckRoute>>(vehicle_src, problem->trucks_count + vehicle_src);
                     for (std::size_t vehicle_dest = 0; vehicle_dest < problem->trucks_count + problem->drones_count; vehicle_dest++)
                     {
-                        const auto &customers = original_vehicle_routes_src[vehicle_src][route_src].customers();
-                        for (std::size_t i = 1; i + Z < customers.size(); i++)
+                        if (!this->_focused(vehicle, vehicle_dest))
                         {
-                            /* Append [i, i + Z) from route_src to vehicle_dest */
-                            std::vector<std::size_t> new_customers(customers.begin(), customers.begin() + i);
-                            new_customers.insert(new_customers.end(), customers.begin() + (i + Z), customers.end());
+                            continue;
+                        }
 
-                            std::vector<std::size_t> detached = {0};
-                            detached.insert(detached.end(), customers.begin() + i, customers.begin() + (i + Z));
-                            detached.push_back(0);
+                        const auto &original = original_vehicle_routes_src[vehicle_src][route_src];
+                        const auto &customers = original.customers();
+                        const auto &aggregates = original.aggregates();
+                        const auto working_time = this->_working_time_bound(solution, {vehicle, vehicle_dest});
+
+                        // Capacity violation of the unmodified routes
+                        const auto capacity_violation = solution->capacity_violation - original.capacity_violation();
+                        for (std::size_t i = 1; i + Z < customers.size(); i++)
+                        {
+                            if (this->_skip())
+                            {
+                                continue;
+                            }
 
                             if constexpr (std::is_same_v<_RT_Src, TruckRoute>)
                             {
-                                if (vehicle_dest >= problem->trucks_count &&
-                                    std::any_of(
-                                        detached.begin() + 1, detached.end() - 1, /* excluding depot */
-                                        [&problem](const std::size_t &c)
-                                        { return !problem->customers[c].dronable; }))
+                                if (vehicle_dest >= problem->trucks_count && !aggregates.dronable(i, i + Z))
                                 {
                                     continue;
                                 }
                             }
 
-                            /* Temporary modify */
-                            if (new_customers.size() == 2) // route_src is now empty, check for no-op moves
+                            // route_src is now empty, check for no-op moves
+                            const bool src_empty = (customers.size() == Z + 2);
+                            if (src_empty)
                             {
                                 if constexpr (std::is_same_v<_RT_Src, TruckRoute>)
                                 {
@@ -190,7 +210,34 @@ namespace d2d
                                         continue;
                                     }
                                 }
+                            }
+
+                            this->_pair = NeighborhoodStatistics::pair_index(std::is_same_v<_RT_Src, TruckRoute>, vehicle_dest < problem->trucks_count);
+
+                            const auto demand = aggregates.demand(i, i + Z);
+                            if (this->_prune(
+                                    working_time,
+                                    capacity_violation +
+                                        this->template _capacity_violation<_RT_Src>(original.weight() - demand) +
+                                        (vehicle_dest < problem->trucks_count
+                                             ? this->template _capacity_violation<TruckRoute>(demand)
+                                             : this->template _capacity_violation<DroneRoute>(demand)),
+                                    result))
+                            {
+                                continue;
+                            }
+
+                            /* Append [i, i + Z) from route_src to vehicle_dest */
+                            std::vector<std::size_t> new_customers(customers.begin(), customers.begin() + i);
+                            new_customers.insert(new_customers.end(), customers.begin() + (i + Z), customers.end());
 
+                            std::vector<std::size_t> detached = {0};
+                            detached.insert(detached.end(), customers.begin() + i, customers.begin() + (i + Z));
+                            detached.push_back(0);
+
+                            /* Temporary modify */
+                            if (src_empty)
+                            {
                                 vehicle_routes_src[vehicle_src].erase(vehicle_routes_src[vehicle_src].begin() + route_src);
                             }
                             else
@@ -209,17 +256,10 @@ namespace d2d
 
                             std::vector<std::size_t> new_tabu(customers.begin() + i, customers.begin() + (i + Z));
 
-                            auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                            if (solution->cost() != new_solution->cost() &&
-                                (aspiration_criteria(new_solution) || !this->is_tabu(new_tabu)) &&
-                                (result == nullptr || new_solution->cost() < result->cost()))
-                            {
-                                result = new_solution;
-                                tabu = new_tabu;
-                            }
+                            this->_evaluate(solution, parent, truck_routes, drone_routes, new_tabu, aspiration_criteria, result, tabu);
 
                             /* Restore */
-                            if (new_customers.size() == 2)
+                            if (src_empty)
                             {
                                 vehicle_routes_src[vehicle_src].insert(
                                     vehicle_routes_src[vehicle_src].begin() + route_src,
@@ -249,9 +289,10 @@ namespace d2d
             return utils::format("Move (%d, %d)", X, Y);
         }
 
+        template <typename _AC, std::enable_if_t<is_aspiration_criteria_v<_AC, ST>, bool> = true>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> inter_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AC &aspiration_criteria)
         {
             auto problem = Problem::get_instance();
             auto parent = this->parent_ptr(solution);
@@ -259,34 +300,31 @@ namespace d2d
             std::shared_ptr<ST> result;
             std::vector<std::size_t> tabu;
 
-            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes);
-            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes);
+            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes());
+            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes());
 
-            for (std::size_t vehicle_i = 0; vehicle_i < problem->trucks_count + problem->drones_count; vehicle_i++)
+            for (auto &[vehicle_i, vehicle_j] : this->_vehicle_pairs(X == Y))
             {
-                for (std::size_t vehicle_j = (X == Y ? vehicle_i : 0); vehicle_j < problem->trucks_count + problem->drones_count; vehicle_j++)
+                if (vehicle_i < problem->trucks_count)
                 {
-                    if (vehicle_i < problem->trucks_count)
+                    if (vehicle_j < problem->trucks_count)
                     {
-                        if (vehicle_j < problem->trucks_count)
-                        {
-                            _inter_route_internal<TruckRoute, TruckRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes, vehicle_i, vehicle_j);
-                        }
-                        else
-                        {
-                            _inter_route_internal<TruckRoute, DroneRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes, vehicle_i, vehicle_j);
-                        }
+                        _inter_route_internal<TruckRoute, TruckRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes, vehicle_i, vehicle_j);
                     }
                     else
                     {
-                        if (vehicle_j < problem->trucks_count)
-                        {
-                            _inter_route_internal<DroneRoute, TruckRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes, vehicle_i, vehicle_j);
-                        }
-                        else
-                        {
-                            _inter_route_internal<DroneRoute, DroneRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes, vehicle_i, vehicle_j);
-                        }
+                        _inter_route_internal<TruckRoute, DroneRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes, vehicle_i, vehicle_j);
+                    }
+                }
+                else
+                {
+                    if (vehicle_j < problem->trucks_count)
+                    {
+                        _inter_route_internal<DroneRoute, TruckRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes, vehicle_i, vehicle_j);
+                    }
+                    else
+                    {
+                        _inter_route_internal<DroneRoute, DroneRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes, vehicle_i, vehicle_j);
                     }
                 }
             }
@@ -305,10 +343,10 @@ namespace d2d
     class MoveXY : public _BaseMoveXY<ST, X, Y>
     {
     private:
-        template <typename _RT, std::enable_if_t<is_route_v<_RT>, bool> = true>
+        template <typename _RT, typename _AC, std::enable_if_t<is_route_v<_RT> && is_aspiration_criteria_v<_AC, ST>, bool> = true>
         void _intra_route_internal(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria,
+            const _AC &aspiration_criteria,
             const std::shared_ptr<ParentInfo<ST>> parent,
             std::shared_ptr<ST> &result,
             std::vector<std::size_t> &tabu,
@@ -318,13 +356,18 @@ namespace d2d
             const std::size_t &_Y)
         {
             auto problem = Problem::get_instance();
+            this->template _set_pair<_RT>();
 
             auto vehicles_count = utils::ternary<std::is_same_v<_RT, TruckRoute>>(problem->trucks_count, problem->drones_count);
             auto &vehicle_routes = utils::match_type<std::vector<std::vector<_RT>>>(truck_routes, drone_routes);
-            auto &original_vehicle_routes = utils::match_type<std::vector<std::vector<_RT>>>(solution->truck_routes, solution->drone_routes);
+            auto &original_vehicle_routes = utils::match_type<std::vector<std::vector<_RT>>>(solution->truck_routes(), solution->drone_routes());
 
             for (std::size_t index = 0; index < vehicles_count; index++)
             {
+                const auto vehicle = utils::ternary<std::is_same_v<_RT, TruckRoute>>(index, problem->trucks_count + index);
+
+                // Intra-route moves keep the loads of all routes
+                const auto working_time = this->_working_time_bound(solution, {vehicle});
                 for (std::size_t route = 0; route < original_vehicle_routes[index].size(); route++)
                 {
                     const auto &customers = original_vehicle_routes[index][route].customers();
@@ -332,6 +375,11 @@ namespace d2d
                     {
                         for (std::size_t j = i + _X; j + _Y < customers.size(); j++)
                         {
+                            if (this->_skip() || this->_prune(working_time, solution->capacity_violation, result))
+                            {
+                                continue;
+                            }
+
                             /* Swap [i, i + _X) and [j, j + _Y) */
                             std::vector<std::size_t> new_customers(customers);
                             if (_X > _Y)
@@ -351,14 +399,7 @@ namespace d2d
                             std::vector<std::size_t> new_tabu(customers.begin() + i, customers.begin() + (i + _X));
                             new_tabu.insert(new_tabu.end(), customers.begin() + j, customers.begin() + (j + _Y));
 
-                            auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                            if (solution->cost() != new_solution->cost() &&
-                                (aspiration_criteria(new_solution) || !this->is_tabu(new_tabu)) &&
-                                (result == nullptr || new_solution->cost() < result->cost()))
-                            {
-                                result = new_solution;
-                                tabu = new_tabu;
-                            }
+                            this->_evaluate(solution, parent, truck_routes, drone_routes, new_tabu, aspiration_criteria, result, tabu);
 
                             /* Restore */
                             vehicle_routes[index][route] = original_vehicle_routes[index][route];
@@ -368,18 +409,19 @@ namespace d2d
             }
         }
 
-    protected:
+    public:
+        template <typename _AC, std::enable_if_t<is_aspiration_criteria_v<_AC, ST>, bool> = true>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> intra_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AC &aspiration_criteria)
         {
             auto parent = this->parent_ptr(solution);
 
             std::shared_ptr<ST> result;
             std::vector<std::size_t> tabu;
 
-            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes);
-            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes);
+            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes());
+            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes());
 
             _intra_route_internal<TruckRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes, X, Y);
             _intra_route_internal<DroneRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes, X, Y);
@@ -397,10 +439,10 @@ namespace d2d
     class MoveXY<ST, X, 0> : public _BaseMoveXY<ST, X, 0>
     {
     private:
-        template <typename _RT, std::enable_if_t<is_route_v<_RT>, bool> = true>
+        template <typename _RT, typename _AC, std::enable_if_t<is_route_v<_RT> && is_aspiration_criteria_v<_AC, ST>, bool> = true>
         void _intra_route_internal(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria,
+            const _AC &aspiration_criteria,
             const std::shared_ptr<ParentInfo<ST>> parent,
             std::shared_ptr<ST> &result,
             std::vector<std::size_t> &tabu,
@@ -408,13 +450,18 @@ namespace d2d
             std::vector<std::vector<DroneRoute>> &drone_routes)
         {
             auto problem = Problem::get_instance();
+            this->template _set_pair<_RT>();
 
             auto vehicles_count = utils::ternary<std::is_same_v<_RT, TruckRoute>>(problem->trucks_count, problem->drones_count);
             auto &vehicle_routes = utils::match_type<std::vector<std::vector<_RT>>>(truck_routes, drone_routes);
-            auto &original_vehicle_routes = utils::match_type<std::vector<std::vector<_RT>>>(solution->truck_routes, solution->drone_routes);
+            auto &original_vehicle_routes = utils::match_type<std::vector<std::vector<_RT>>>(solution->truck_routes(), solution->drone_routes());
 
             for (std::size_t index = 0; index < vehicles_count; index++)
             {
+                const auto vehicle = utils::ternary<std::is_same_v<_RT, TruckRoute>>(index, problem->trucks_count + index);
+
+                // Intra-route moves keep the loads of all routes
+                const auto working_time = this->_working_time_bound(solution, {vehicle});
                 for (std::size_t route = 0; route < original_vehicle_routes[index].size(); route++)
                 {
                     const auto &customers = original_vehicle_routes[index][route].customers();
@@ -422,6 +469,11 @@ namespace d2d
                     {
                         for (std::size_t j = 1; j < i; j++)
                         {
+                            if (this->_skip() || this->_prune(working_time, solution->capacity_violation, result))
+                            {
+                                continue;
+                            }
+
                             /* Move [i, i + X) to position j (customers[j] = customers[i]) */
                             std::vector<std::size_t> new_customers(customers);
                             std::rotate(new_customers.begin() + j, new_customers.begin() + i, new_customers.begin() + (i + X));
@@ -430,14 +482,7 @@ namespace d2d
 
                             std::vector<std::size_t> new_tabu(customers.begin() + i, customers.begin() + (i + X));
 
-                            auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                            if (solution->cost() != new_solution->cost() &&
-                                (aspiration_criteria(new_solution) || !this->is_tabu(new_tabu)) &&
-                                (result == nullptr || new_solution->cost() < result->cost()))
-                            {
-                                result = new_solution;
-                                tabu = new_tabu;
-                            }
+                            this->_evaluate(solution, parent, truck_routes, drone_routes, new_tabu, aspiration_criteria, result, tabu);
 
                             /* Restore */
                             vehicle_routes[index][route] = original_vehicle_routes[index][route];
@@ -445,6 +490,11 @@ namespace d2d
 
                         for (std::size_t j = i + X; j + 1 < customers.size(); j++)
                         {
+                            if (this->_skip() || this->_prune(working_time, solution->capacity_violation, result))
+                            {
+                                continue;
+                            }
+
                             /* Move [i, i + X) to position j (customers[j] = customers[i]) */
                             std::vector<std::size_t> new_customers(customers);
                             std::rotate(new_customers.begin() + i, new_customers.begin() + (i + X), new_customers.begin() + (j + 1));
@@ -453,14 +503,7 @@ namespace d2d
 
                             std::vector<std::size_t> new_tabu(customers.begin() + i, customers.begin() + (i + X));
 
-                            auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                            if (solution->cost() != new_solution->cost() &&
-                                (aspiration_criteria(new_solution) || !this->is_tabu(new_tabu)) &&
-                                (result == nullptr || new_solution->cost() < result->cost()))
-                            {
-                                result = new_solution;
-                                tabu = new_tabu;
-                            }
+                            this->_evaluate(solution, parent, truck_routes, drone_routes, new_tabu, aspiration_criteria, result, tabu);
 
                             /* Restore */
                             vehicle_routes[index][route] = original_vehicle_routes[index][route];
@@ -470,18 +513,19 @@ namespace d2d
             }
         }
 
-    protected:
+    public:
+        template <typename _AC, std::enable_if_t<is_aspiration_criteria_v<_AC, ST>, bool> = true>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> intra_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AC &aspiration_criteria)
         {
             auto parent = this->parent_ptr(solution);
 
             std::shared_ptr<ST> result;
             std::vector<std::size_t> tabu;
 
-            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes);
-            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes);
+            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes());
+            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes());
 
             _intra_route_internal<TruckRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes);
             _intra_route_internal<DroneRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes);
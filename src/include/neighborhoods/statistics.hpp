@@ -0,0 +1,96 @@
+#pragma once
+
+#include "../routes.hpp"
+
+namespace d2d
+{
+    /**
+     * @brief Performance counters of a neighborhood, split by the vehicle types of the routes
+     * modified by each move.
+     */
+    struct NeighborhoodStatistics
+    {
+        static constexpr std::size_t TRUCK_TRUCK = 0, TRUCK_DRONE = 1, DRONE_DRONE = 2;
+        static constexpr std::array<const char *, 3> PAIR_LABELS = {"truck-truck", "truck-drone", "drone-drone"};
+
+        struct Counters
+        {
+            /** @brief Candidate solutions constructed */
+            std::uint64_t generated = 0;
+
+            /** @brief Candidates rejected by cheap bound checks before being constructed */
+            std::uint64_t pruned = 0;
+
+            /** @brief Candidates compared against the best move so far (i.e. not a no-op) */
+            std::uint64_t evaluated = 0;
+
+            /** @brief Evaluated candidates that are feasible */
+            std::uint64_t feasible = 0;
+
+            /** @brief Evaluated candidates rejected by the tabu list */
+            std::uint64_t tabu_rejected = 0;
+
+            /** @brief Evaluated candidates satisfying the aspiration criteria */
+            std::uint64_t aspiration_hits = 0;
+
+            /** @brief Tabu search iterations whose move came from this neighborhood */
+            std::uint64_t wins = 0;
+
+            /** @brief Total cost decrease of the winning moves (negative for deteriorating moves) */
+            double improvement = 0;
+
+            Counters &operator+=(const Counters &other)
+            {
+                generated += other.generated;
+                pruned += other.pruned;
+                evaluated += other.evaluated;
+                feasible += other.feasible;
+                tabu_rejected += other.tabu_rejected;
+                aspiration_hits += other.aspiration_hits;
+                wins += other.wins;
+                improvement += other.improvement;
+                return *this;
+            }
+        };
+
+        std::array<Counters, 3> pairs;
+
+        /** @brief Time spent exploring the neighborhood, in seconds */
+        double elapsed = 0;
+
+        NeighborhoodStatistics &operator+=(const NeighborhoodStatistics &other)
+        {
+            for (std::size_t i = 0; i < pairs.size(); i++)
+            {
+                pairs[i] += other.pairs[i];
+            }
+            elapsed += other.elapsed;
+            return *this;
+        }
+
+        Counters total() const
+        {
+            Counters result;
+            for (auto &counters : pairs)
+            {
+                result += counters;
+            }
+
+            return result;
+        }
+
+        static constexpr std::size_t pair_index(const bool truck_i, const bool truck_j)
+        {
+            return truck_i && truck_j ? TRUCK_TRUCK : (truck_i || truck_j ? TRUCK_DRONE : DRONE_DRONE);
+        }
+
+        /** @brief The pair index of a move modifying routes of the given types */
+        template <typename... RTs, std::enable_if_t<is_route_v<RTs...>, bool> = true>
+        static constexpr std::size_t pair_index()
+        {
+            constexpr bool all_trucks = (std::is_same_v<RTs, TruckRoute> && ...);
+            constexpr bool any_truck = (std::is_same_v<RTs, TruckRoute> || ...);
+            return all_trucks ? TRUCK_TRUCK : (any_truck ? TRUCK_DRONE : DRONE_DRONE);
+        }
+    };
+}
@@ -5,13 +5,13 @@
 namespace d2d
 {
     template <typename ST>
-    class TwoOpt : public Neighborhood<ST, true>
+    class TwoOpt : public CRTPNeighborhood<ST, true, TwoOpt<ST>>
     {
     private:
-        template <typename _RT, std::enable_if_t<is_route_v<_RT>, bool> = true>
+        template <typename _RT, typename _AC, std::enable_if_t<is_route_v<_RT> && is_aspiration_criteria_v<_AC, ST>, bool> = true>
         void _intra_route_internal(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria,
+            const _AC &aspiration_criteria,
             const std::shared_ptr<ParentInfo<ST>> parent,
             std::shared_ptr<ST> &result,
             std::vector<std::size_t> &tabu,
@@ -19,13 +19,18 @@ namespace d2d
             std::vector<std::vector<DroneRoute>> &drone_routes)
         {
             auto problem = Problem::get_instance();
+            this->template _set_pair<_RT>();
 
             auto vehicles_count = utils::ternary<std::is_same_v<_RT, TruckRoute>>(problem->trucks_count, problem->drones_count);
             auto &vehicle_routes = utils::match_type<std::vector<std::vector<_RT>>>(truck_routes, drone_routes);
-            auto &original_vehicle_routes = utils::match_type<std::vector<std::vector<_RT>>>(solution->truck_routes, solution->drone_routes);
+            auto &original_vehicle_routes = utils::match_type<std::vector<std::vector<_RT>>>(solution->truck_routes(), solution->drone_routes());
 
             for (std::size_t index = 0; index < vehicles_count; index++)
             {
+                const auto vehicle = utils::ternary<std::is_same_v<_RT, TruckRoute>>(index, problem->trucks_count + index);
+
+                // Intra-route moves keep the loads of all routes
+                const auto working_time = this->_working_time_bound(solution, {vehicle});
                 for (std::size_t route = 0; route < original_vehicle_routes[index].size(); route++)
                 {
                     const auto &customers = original_vehicle_routes[index][route].customers();
@@ -33,20 +38,19 @@ namespace d2d
                     {
                         for (std::size_t j = i + 1; j + 1 < customers.size(); j++)
                         {
+                            if (this->_skip() || this->_prune(working_time, solution->capacity_violation, result))
+                            {
+                                continue;
+                            }
+
                             /* Reverse segment [i, j] */
                             std::vector<std::size_t> new_customers(customers);
                             std::reverse(new_customers.begin() + i, new_customers.begin() + (j + 1));
 
                             vehicle_routes[index][route] = _RT(new_customers);
 
-                            auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                            if (solution->cost() != new_solution->cost() &&
-                                (aspiration_criteria(new_solution) || !this->is_tabu(customers[i - 1], customers[j])) &&
-                                (result == nullptr || new_solution->cost() < result->cost()))
-                            {
-                                result = new_solution;
-                                tabu = {customers[i - 1], customers[j]};
-                            }
+                            std::vector<std::size_t> new_tabu = {customers[i - 1], customers[j]};
+                            this->_evaluate(solution, parent, truck_routes, drone_routes, new_tabu, aspiration_criteria, result, tabu);
 
                             /* Restore */
                             vehicle_routes[index][route] = original_vehicle_routes[index][route];
@@ -56,10 +60,10 @@ namespace d2d
             }
         }
 
-        template <typename _RT_I, typename _RT_J, std::enable_if_t<is_route_v<_RT_I, _RT_J>, bool> = true>
+        template <typename _RT_I, typename _RT_J, typename _AC, std::enable_if_t<is_route_v<_RT_I, _RT_J> && is_aspiration_criteria_v<_AC, ST>, bool> = true>
         void _inter_route_internal(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria,
+            const _AC &aspiration_criteria,
             const std::shared_ptr<ParentInfo<ST>> parent,
             std::shared_ptr<ST> &result,
             std::vector<std::size_t> &tabu,
@@ -69,15 +73,17 @@ namespace d2d
             const std::size_t &vehicle_j)
         {
             auto problem = Problem::get_instance();
+            this->template _set_pair<_RT_I, _RT_J>();
 
             std::size_t _vehicle_i = utils::ternary<std::is_same_v<_RT_I, TruckRoute>>(vehicle_i, vehicle_i - problem->trucks_count);
             std::size_t _vehicle_j = utils::ternary<std::is_same_v<_RT_J, TruckRoute>>(vehicle_j, vehicle_j - problem->trucks_count);
 
             auto &vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(truck_routes, drone_routes);
             auto &vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(truck_routes, drone_routes);
-            auto &original_vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(solution->truck_routes, solution->drone_routes);
-            auto &original_vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(solution->truck_routes, solution->drone_routes);
+            auto &original_vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(solution->truck_routes(), solution->drone_routes());
+            auto &original_vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(solution->truck_routes(), solution->drone_routes());
 
+            const auto working_time = this->_working_time_bound(solution, {vehicle_i, vehicle_j});
             for (std::size_t route_i = 0; route_i < original_vehicle_routes_i[_vehicle_i].size(); route_i++)
             {
                 for (std::size_t route_j = 0; route_j < original_vehicle_routes_j[_vehicle_j].size(); route_j++)
@@ -90,18 +96,35 @@ namespace d2d
                         }
                     }
 
-                    const auto &customers_i = original_vehicle_routes_i[_vehicle_i][route_i].customers();
-                    const auto &customers_j = original_vehicle_routes_j[_vehicle_j][route_j].customers();
+                    const auto &original_i = original_vehicle_routes_i[_vehicle_i][route_i];
+                    const auto &original_j = original_vehicle_routes_j[_vehicle_j][route_j];
+                    const auto &customers_i = original_i.customers();
+                    const auto &customers_j = original_j.customers();
 
+                    // Capacity violation of the unmodified routes
+                    const auto capacity_violation = solution->capacity_violation - original_i.capacity_violation() - original_j.capacity_violation();
+
+                    // Demand of [0, i] of route_i, the tail is carried by the other route
+                    double head_i = 0;
                     for (std::size_t i = 0; i + 1 < customers_i.size(); i++)
                     {
+                        head_i += problem->columns.demand[customers_i[i]];
+
+                        double head_j = 0;
                         for (std::size_t j = 0; j + 1 < customers_j.size(); j++)
                         {
+                            head_j += problem->columns.demand[customers_j[j]];
+
+                            if (this->_skip())
+                            {
+                                continue;
+                            }
+
                             if constexpr (std::is_same_v<_RT_I, DroneRoute> && std::is_same_v<_RT_J, TruckRoute>)
                             {
                                 if (std::any_of(
                                         customers_j.begin() + (j + 1), customers_j.end(), [&problem](const std::size_t &c)
-                                        { return !problem->customers[c].dronable; }))
+                                        { return !problem->columns.dronable[c]; }))
                                 {
                                     continue;
                                 }
@@ -111,12 +134,22 @@ namespace d2d
                             {
                                 if (std::any_of(
                                         customers_i.begin() + (i + 1), customers_i.end(), [&problem](const std::size_t &c)
-                                        { return !problem->customers[c].dronable; }))
+                                        { return !problem->columns.dronable[c]; }))
                                 {
                                     continue;
                                 }
                             }
 
+                            if (this->_prune(
+                                    working_time,
+                                    capacity_violation +
+                                        this->template _capacity_violation<_RT_I>(head_i + original_j.weight() - head_j) +
+                                        this->template _capacity_violation<_RT_J>(head_j + original_i.weight() - head_i),
+                                    result))
+                            {
+                                continue;
+                            }
+
                             /* Swap [i + 1, end()) of route_i and [j + 1, end()) of route_j */
                             std::vector<std::size_t> ri(customers_i.begin(), customers_i.begin() + (i + 1));
                             std::vector<std::size_t> rj(customers_j.begin(), customers_j.begin() + (j + 1));
@@ -142,14 +175,8 @@ namespace d2d
                                 vehicle_routes_j[_vehicle_j][route_j] = _RT_J(rj);
                             }
 
-                            auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                            if (solution->cost() != new_solution->cost() &&
-                                (aspiration_criteria(new_solution) || !this->is_tabu(customers_i[i], customers_j[j])) &&
-                                (result == nullptr || new_solution->cost() < result->cost()))
-                            {
-                                result = new_solution;
-                                tabu = {customers_i[i], customers_j[j]};
-                            }
+                            std::vector<std::size_t> new_tabu = {customers_i[i], customers_j[j]};
+                            this->_evaluate(solution, parent, truck_routes, drone_routes, new_tabu, aspiration_criteria, result, tabu);
 
                             /* Restore */
                             vehicle_routes_i[_vehicle_i] = original_vehicle_routes_i[_vehicle_i];
@@ -166,17 +193,18 @@ namespace d2d
             return "2-opt";
         }
 
+        template <typename _AC, std::enable_if_t<is_aspiration_criteria_v<_AC, ST>, bool> = true>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> intra_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AC &aspiration_criteria)
         {
             auto parent = this->parent_ptr(solution);
 
             std::shared_ptr<ST> result;
             std::vector<std::size_t> tabu;
 
-            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes);
-            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes);
+            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes());
+            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes());
 
             _intra_route_internal<TruckRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes);
             _intra_route_internal<DroneRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes);
@@ -184,52 +212,38 @@ namespace d2d
             return std::make_pair(result, tabu);
         }
 
+        template <typename _AC, std::enable_if_t<is_aspiration_criteria_v<_AC, ST>, bool> = true>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> inter_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AC &aspiration_criteria)
         {
             auto problem = Problem::get_instance();
             auto parent = this->parent_ptr(solution);
             std::shared_ptr<ST> result;
             std::vector<std::size_t> tabu;
 
-            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes);
-            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes);
+            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes());
+            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes());
 
-            for (std::size_t vehicle_i = 0; vehicle_i < problem->trucks_count + problem->drones_count; vehicle_i++)
+            for (auto &[vehicle_i, vehicle_j] : this->_vehicle_pairs(true))
             {
-                for (std::size_t vehicle_j = vehicle_i; vehicle_j < problem->trucks_count + problem->drones_count; vehicle_j++)
+                if (vehicle_i < problem->trucks_count)
                 {
-                    if (vehicle_i < problem->trucks_count)
+                    if (vehicle_j < problem->trucks_count)
                     {
-                        if (vehicle_j < problem->trucks_count)
-                        {
-                            _inter_route_internal<TruckRoute, TruckRoute>(
-                                solution,
-                                aspiration_criteria,
-                                parent, result,
-                                tabu,
-                                truck_routes,
-                                drone_routes,
-                                vehicle_i,
-                                vehicle_j);
-                        }
-                        else
-                        {
-                            _inter_route_internal<TruckRoute, DroneRoute>(
-                                solution,
-                                aspiration_criteria,
-                                parent, result,
-                                tabu,
-                                truck_routes,
-                                drone_routes,
-                                vehicle_i,
-                                vehicle_j);
-                        }
+                        _inter_route_internal<TruckRoute, TruckRoute>(
+                            solution,
+                            aspiration_criteria,
+                            parent, result,
+                            tabu,
+                            truck_routes,
+                            drone_routes,
+                            vehicle_i,
+                            vehicle_j);
                     }
                     else
                     {
-                        _inter_route_internal<DroneRoute, DroneRoute>(
+                        _inter_route_internal<TruckRoute, DroneRoute>(
                             solution,
                             aspiration_criteria,
                             parent, result,
@@ -240,6 +254,18 @@ namespace d2d
                             vehicle_j);
                     }
                 }
+                else
+                {
+                    _inter_route_internal<DroneRoute, DroneRoute>(
+                        solution,
+                        aspiration_criteria,
+                        parent, result,
+                        tabu,
+                        truck_routes,
+                        drone_routes,
+                        vehicle_i,
+                        vehicle_j);
+                }
             }
 
             return std::make_pair(result, tabu);
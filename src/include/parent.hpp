@@ -8,12 +8,15 @@ namespace d2d
     class ParentInfo
     {
     public:
+        /** @brief Whether to keep parent solutions alive for the lineage output (`LOGGING` only) */
+        static inline bool keep_lineage = true;
+
         const std::shared_ptr<ST> ptr;
         const std::string label;
 
         ParentInfo(const std::shared_ptr<ST> ptr, const std::string &label) :
 #ifdef LOGGING
-                                                                              ptr(ptr),
+                                                                              ptr(keep_lineage ? ptr : nullptr),
 #else
                                                                               ptr(nullptr),
 #endif
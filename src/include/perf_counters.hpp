@@ -0,0 +1,158 @@
+#pragma once
+
+#include "utils.hpp"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+namespace utils
+{
+    /**
+     * @brief Hardware performance counters of the calling thread, read through Linux `perf_event_open`.
+     *
+     * Events are opened independently, so that events unsupported by the CPU (or hidden by a
+     * hypervisor) are simply reported as unavailable. When the kernel multiplexes counters, the
+     * values are scaled by the fraction of time each counter was actually running.
+     *
+     * On other platforms, construction always fails.
+     */
+    class PerfCounters
+    {
+    public:
+        struct Event
+        {
+            const char *name;
+            std::uint32_t type;
+            std::uint64_t config;
+        };
+
+        static constexpr std::size_t EVENTS_COUNT = 5;
+
+#if defined(__linux__)
+        static constexpr std::array<Event, EVENTS_COUNT> EVENTS = {
+            Event{"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            Event{"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            Event{"L1d-misses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+            Event{"LLC-misses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+            Event{"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        };
+#else
+        static constexpr std::array<Event, EVENTS_COUNT> EVENTS = {
+            Event{"cycles", 0, 0},
+            Event{"instructions", 0, 0},
+            Event{"L1d-misses", 0, 0},
+            Event{"LLC-misses", 0, 0},
+            Event{"branch-misses", 0, 0},
+        };
+#endif
+
+        /** @brief Counter values, `std::nullopt` for unavailable events */
+        using values_t = std::array<std::optional<double>, EVENTS_COUNT>;
+
+    private:
+        std::array<int, EVENTS_COUNT> _fds;
+
+    public:
+        /**
+         * @brief Open the counters for the calling thread, initially disabled.
+         *
+         * @throw std::runtime_error If no event could be opened (e.g. `perf_event_paranoid` is too
+         * restrictive, or the platform is not Linux)
+         */
+        PerfCounters()
+        {
+            _fds.fill(-1);
+
+#if defined(__linux__)
+            int error = 0;
+            for (std::size_t i = 0; i < EVENTS_COUNT; i++)
+            {
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = EVENTS[i].type;
+                attr.config = EVENTS[i].config;
+                attr.disabled = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                _fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+                if (_fds[i] == -1)
+                {
+                    error = errno;
+                }
+            }
+
+            if (std::all_of(_fds.begin(), _fds.end(), [](const int &fd)
+                            { return fd == -1; }))
+            {
+                throw std::runtime_error(utils::format("perf_event_open failed: %s", std::strerror(error)));
+            }
+#else
+            throw std::runtime_error("Hardware counters are only supported on Linux");
+#endif
+        }
+
+        PerfCounters(const PerfCounters &) = delete;
+        PerfCounters &operator=(const PerfCounters &) = delete;
+
+        ~PerfCounters()
+        {
+#if defined(__linux__)
+            for (auto &fd : _fds)
+            {
+                if (fd != -1)
+                {
+                    close(fd);
+                }
+            }
+#endif
+        }
+
+        /** @brief Reset and enable all counters */
+        void start()
+        {
+#if defined(__linux__)
+            for (auto &fd : _fds)
+            {
+                if (fd != -1)
+                {
+                    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+                }
+            }
+#endif
+        }
+
+        /** @brief Disable all counters and read their values since the last `start` */
+        values_t stop()
+        {
+            values_t result;
+
+#if defined(__linux__)
+            for (auto &fd : _fds)
+            {
+                if (fd != -1)
+                {
+                    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+                }
+            }
+
+            for (std::size_t i = 0; i < EVENTS_COUNT; i++)
+            {
+                // value, time_enabled, time_running
+                std::uint64_t buffer[3];
+                if (_fds[i] != -1 && read(_fds[i], buffer, sizeof(buffer)) == sizeof(buffer) && buffer[2] > 0)
+                {
+                    result[i] = static_cast<double>(buffer[0]) * buffer[1] / buffer[2];
+                }
+            }
+#endif
+
+            return result;
+        }
+    };
+}
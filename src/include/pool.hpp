@@ -0,0 +1,243 @@
+#pragma once
+
+#include "utils.hpp"
+
+namespace utils
+{
+    /**
+     * @brief A thread-local free list of memory blocks of a fixed size.
+     *
+     * Blocks are never returned to the global allocator until the owning thread exits, so that a
+     * released block is immediately reused by the next allocation of the same size. A block may be
+     * released by another thread than the one that acquired it: it simply joins the free list of
+     * the releasing thread.
+     */
+    template <std::size_t _Size>
+    class FixedBlockPool
+    {
+    private:
+        static_assert(_Size >= sizeof(void *));
+
+        struct _FreeList
+        {
+            void *head = nullptr;
+            std::size_t size = 0;
+
+            ~_FreeList()
+            {
+                while (head != nullptr)
+                {
+                    auto next = *static_cast<void **>(head);
+                    ::operator delete(head);
+                    head = next;
+                }
+
+                _destroyed = true;
+            }
+        };
+
+        static _FreeList &_free()
+        {
+            thread_local _FreeList list;
+            return list;
+        }
+
+        // Blocks released after the thread-local free list is destroyed (e.g. by static objects at
+        // exit) go back to the global allocator
+        static inline thread_local bool _destroyed = false;
+
+    public:
+        /** @brief Maximum number of free blocks kept by each thread */
+        static constexpr std::size_t MAX_FREE = 4096;
+
+        static void *acquire()
+        {
+            if (!_destroyed)
+            {
+                auto &list = _free();
+                if (list.head != nullptr)
+                {
+                    auto result = list.head;
+                    list.head = *static_cast<void **>(result);
+                    list.size--;
+                    return result;
+                }
+            }
+
+            return ::operator new(_Size);
+        }
+
+        static void release(void *ptr)
+        {
+            if (_destroyed || _free().size >= MAX_FREE)
+            {
+                ::operator delete(ptr);
+                return;
+            }
+
+            auto &list = _free();
+            *static_cast<void **>(ptr) = list.head;
+            list.head = ptr;
+            list.size++;
+        }
+    };
+
+    /**
+     * @brief Heap storage owned by an object, as given by its `heap_size()` member if it has one.
+     * Storage shared between objects is counted for each of them.
+     */
+    template <typename T>
+    std::size_t heap_size(const T &object)
+    {
+        if constexpr (requires { { object.heap_size() } -> std::convertible_to<std::size_t>; })
+        {
+            return object.heap_size();
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    /** @brief Heap storage owned by a vector: its buffer and the heap storage of its elements */
+    template <typename T>
+    std::size_t heap_size(const std::vector<T> &vector)
+    {
+        std::size_t result = vector.capacity() * sizeof(T);
+        if constexpr (!std::is_arithmetic_v<T>)
+        {
+            for (auto &element : vector)
+            {
+                result += heap_size(element);
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief A thread-local free list of discarded objects (typically containers) whose storage is
+     * recycled.
+     *
+     * A released container keeps its capacity, so that refilling an acquired one (e.g. with
+     * `assign`) only allocates when it grows. The free objects of each thread are bounded in number
+     * and in heap storage (see `heap_size`), objects released beyond these bounds are destroyed. As
+     * with `FixedBlockPool`, an object may be released by another thread than the one that acquired
+     * it.
+     */
+    template <typename T>
+    class RecycleBin
+    {
+    private:
+        struct _FreeList
+        {
+            // The free objects and their heap storage
+            std::vector<std::pair<T, std::size_t>> objects;
+            std::size_t bytes = 0;
+
+            ~_FreeList()
+            {
+                _destroyed = true;
+            }
+        };
+
+        static _FreeList &_free()
+        {
+            thread_local _FreeList list;
+            return list;
+        }
+
+        static inline thread_local bool _destroyed = false;
+
+    public:
+        /** @brief Maximum number of free objects kept by each thread */
+        static constexpr std::size_t MAX_FREE = 4096;
+
+        /** @brief Maximum heap storage of the free objects kept by each thread */
+        static constexpr std::size_t MAX_FREE_BYTES = 16 << 20;
+
+        /** @brief A recycled object if any, a default-constructed one otherwise */
+        static T acquire()
+        {
+            if (!_destroyed)
+            {
+                auto &list = _free();
+                if (!list.objects.empty())
+                {
+                    T result(std::move(list.objects.back().first));
+                    list.bytes -= list.objects.back().second;
+                    list.objects.pop_back();
+                    return result;
+                }
+            }
+
+            return T();
+        }
+
+        static void release(T &&object)
+        {
+            if (!_destroyed)
+            {
+                auto &list = _free();
+                const auto bytes = heap_size(object);
+                if (list.objects.size() < MAX_FREE && list.bytes + bytes <= MAX_FREE_BYTES)
+                {
+                    list.objects.emplace_back(std::move(object), bytes);
+                    list.bytes += bytes;
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief A standard allocator serving single objects from a `FixedBlockPool`.
+     *
+     * This is meant for `std::allocate_shared`, which allocates the control block and the object
+     * together in a single block of constant size, e.g.
+     * `std::allocate_shared<Solution>(utils::PoolAllocator<Solution>(), ...)`.
+     */
+    template <typename T>
+    class PoolAllocator
+    {
+    private:
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+        using _pool = FixedBlockPool<std::max(sizeof(T), sizeof(void *))>;
+
+    public:
+        using value_type = T;
+
+        PoolAllocator() noexcept = default;
+
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U> &) noexcept {}
+
+        T *allocate(const std::size_t n)
+        {
+            if (n == 1)
+            {
+                return static_cast<T *>(_pool::acquire());
+            }
+
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T *ptr, const std::size_t n) noexcept
+        {
+            if (n == 1)
+            {
+                _pool::release(ptr);
+            }
+            else
+            {
+                ::operator delete(ptr);
+            }
+        }
+
+        template <typename U>
+        bool operator==(const PoolAllocator<U> &) const noexcept
+        {
+            return true;
+        }
+    };
+}
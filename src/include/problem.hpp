@@ -1,7 +1,13 @@
 #pragma once
 
+#include "bitvector.hpp"
 #include "config.hpp"
 #include "format.hpp"
+#include "instance.hpp"
+#include "instrument.hpp"
+#include "interrupt.hpp"
+#include "json.hpp"
+#include "random.hpp"
 
 namespace d2d
 {
@@ -29,11 +35,59 @@ namespace d2d
               drone_service_time(drone_service_time) {}
     };
 
+    /**
+     * @brief Structure-of-arrays copy of the customer attributes, for evaluation loops that read a
+     * single attribute of many customers. `Problem::customers` remains the reference for I/O.
+     */
+    class CustomerColumns
+    {
+    private:
+        static std::vector<double> _column(const std::vector<Customer> &customers, const double Customer::*attribute)
+        {
+            std::vector<double> result;
+            result.reserve(customers.size());
+            for (auto &customer : customers)
+            {
+                result.push_back(customer.*attribute);
+            }
+
+            return result;
+        }
+
+        static utils::BitVector _dronable(const std::vector<Customer> &customers)
+        {
+            utils::BitVector result(customers.size());
+            for (std::size_t i = 0; i < customers.size(); i++)
+            {
+                if (customers[i].dronable)
+                {
+                    result.set(i);
+                }
+            }
+
+            return result;
+        }
+
+    public:
+        const std::vector<double> x, y, demand, truck_service_time, drone_service_time;
+        const utils::BitVector dronable;
+
+        CustomerColumns(const std::vector<Customer> &customers)
+            : x(_column(customers, &Customer::x)),
+              y(_column(customers, &Customer::y)),
+              demand(_column(customers, &Customer::demand)),
+              truck_service_time(_column(customers, &Customer::truck_service_time)),
+              drone_service_time(_column(customers, &Customer::drone_service_time)),
+              dronable(_dronable(customers)) {}
+    };
+
     class Problem
     {
     private:
         static Problem *_instance;
 
+        const std::chrono::steady_clock::time_point _loaded_at = std::chrono::steady_clock::now();
+
         Problem(
             const double &tabu_size_factor,
             const bool verbose,
@@ -41,7 +95,9 @@ namespace d2d
             const std::size_t &drones_count,
             const double &waiting_time_limit,
             const std::vector<Customer> &customers,
-            const std::vector<std::vector<double>> &distances,
+            const utils::SquareMatrix<double> &distances,
+            const utils::SquareMatrix<double> &truck_distances,
+            const double &truck_distance_scale,
             const double &average_distance,
             const double &total_demand,
             const TruckConfig *const truck,
@@ -55,6 +111,20 @@ namespace d2d
             const std::size_t &reset_after_factor,
             const std::size_t &max_elite_size,
             const std::size_t &destroy_rate,
+            const double &time_limit,
+            const std::string &scan_policy,
+            const double &sample_rate,
+            const double &critical_focus,
+            const std::size_t &critical_period,
+            const double &gap_limit,
+            const double &stagnation_gain,
+            const double &stagnation_spread,
+            const std::string &name,
+            const std::string &trace_path,
+            const std::string &output_path,
+            const std::string &profile_path,
+            const int &profile_level,
+            const std::string &control_path,
 
             const std::optional<std::pair<std::vector<std::vector<std::vector<std::size_t>>>, std::vector<std::vector<std::vector<std::size_t>>>>> &evaluate)
             : tabu_size_factor(tabu_size_factor),
@@ -63,7 +133,10 @@ namespace d2d
               drones_count(drones_count),
               waiting_time_limit(waiting_time_limit),
               customers(customers),
+              columns(customers),
               distances(distances),
+              truck_distances(truck_distances),
+              truck_distance_scale(truck_distance_scale),
               average_distance(average_distance),
               total_demand(total_demand),
               truck(truck),
@@ -76,6 +149,20 @@ namespace d2d
               reset_after_factor(reset_after_factor),
               max_elite_size(max_elite_size),
               destroy_rate(destroy_rate),
+              time_limit(time_limit),
+              scan_policy(scan_policy),
+              sample_rate(sample_rate),
+              critical_focus(critical_focus),
+              critical_period(critical_period),
+              gap_limit(gap_limit),
+              stagnation_gain(stagnation_gain),
+              stagnation_spread(stagnation_spread),
+              name(name),
+              trace_path(trace_path),
+              output_path(output_path),
+              profile_path(profile_path),
+              profile_level(profile_level),
+              control_path(control_path),
               evaluate(evaluate)
         {
         }
@@ -86,13 +173,62 @@ namespace d2d
             delete drone;
         }
 
+        static Problem *_create(
+            const double &tabu_size_factor,
+            const bool verbose,
+            const std::size_t &trucks_count,
+            const std::size_t &drones_count,
+            const double &waiting_time_limit,
+            const std::vector<Customer> &customers,
+            const utils::SquareMatrix<double> &distances,
+            const utils::SquareMatrix<double> &truck_distances,
+            const double &truck_distance_scale,
+            const double &average_distance,
+            const TruckConfig *const truck,
+            const _BaseDroneConfig *const drone,
+            const std::string &strategy,
+            const int &fix_iteration,
+            const std::size_t &reset_after_factor,
+            const std::size_t &max_elite_size,
+            const std::size_t &destroy_rate,
+            const double &time_limit,
+            const std::string &scan_policy,
+            const double &sample_rate,
+            const double &critical_focus,
+            const std::size_t &critical_period,
+            const double &gap_limit,
+            const double &stagnation_gain,
+            const double &stagnation_spread,
+            const std::string &name,
+            const std::string &trace_path,
+            const std::string &output_path,
+            const std::string &profile_path,
+            const int &profile_level,
+            const std::string &control_path,
+            const std::optional<std::pair<std::vector<std::vector<std::vector<std::size_t>>>, std::vector<std::vector<std::vector<std::size_t>>>>> &evaluate);
+
     public:
         const double tabu_size_factor;
         const bool verbose;
         const std::size_t trucks_count, drones_count;
         const double waiting_time_limit;
         const std::vector<Customer> customers;
-        const std::vector<std::vector<double>> distances;
+
+        // The same customers, one array per attribute
+        const CustomerColumns columns;
+
+        const utils::SquareMatrix<double> distances;
+
+        // Distances traveled by trucks, which follow roads. Same storage as `distances` unless a
+        // road-distance matrix is provided. Read them through `truck_distance()`, which applies
+        // `truck_distance_scale`.
+        const utils::SquareMatrix<double> truck_distances;
+
+        // Factor converting `truck_distances` to distances, other than 1 only when the matrix holds
+        // travel times at the maximum truck velocity.
+        const double truck_distance_scale;
+
+        // Average Euclidean distance between two nodes, also when trucks use `truck_distances`
         const double average_distance;
         const double total_demand;
         const TruckConfig *const truck;
@@ -107,13 +243,84 @@ namespace d2d
         const std::size_t max_elite_size;
         const std::size_t destroy_rate;
 
+        // Wall-clock budget of the run in seconds, non-positive for no limit. The tabu search stops
+        // after `SEARCH_TIME_FRACTION` of it, the rest is left to post-optimization.
+        const double time_limit;
+        static constexpr double SEARCH_TIME_FRACTION = 0.9;
+
+        // Scan policy of the tabu search neighborhoods ("auto", "best", "first" or "sampled") and the
+        // fraction of candidates evaluated by the sampled policy, see `ScanPolicy`
+        const std::string scan_policy;
+        const double sample_rate;
+
+        // Relative distance to the makespan within which a vehicle is critical, negative to disable
+        // the critical focus of inter-route scans, and the period (in iterations) of the full scans
+        // in this mode, see `ScanPolicy::critical_focus`
+        const double critical_focus;
+        const std::size_t critical_period;
+
+        // The tabu search stops once the relative gap (wt - lb) / wt between the best feasible working
+        // time wt and the lower bound lb of `LowerBound` is at most this value, negative to disable
+        const double gap_limit;
+
+        // At each reset of the tabu search, the search is stagnating if the expected relative improvement
+        // over the next `reset_after` iterations is below `stagnation_gain` (negative to disable) and the
+        // elite spread is at most `stagnation_spread`, see `utils::StagnationMonitor`
+        const double stagnation_gain;
+        const double stagnation_spread;
+
+        // Problem name, empty if unknown (e.g. when read from stdin)
+        const std::string name;
+
+        // Path of the streaming search trace, empty if disabled
+        const std::string trace_path;
+
+        // Path of the JSON-lines result file, empty to print the text output to stdout instead
+        const std::string output_path;
+
+        // Path of the instrumentation trace (Chrome trace format) and its level, see `utils::Instrumentation`
+        const std::string profile_path;
+        const int profile_level;
+
+        // Path of the control file (typically a named pipe) polled for a "stop" line, see `utils::Interruption`
+        const std::string control_path;
+
         const std::optional<std::pair<std::vector<std::vector<std::vector<std::size_t>>>, std::vector<std::vector<std::vector<std::size_t>>>>> evaluate;
 
         // These will be calculated later
         std::size_t tabu_size;
         std::size_t reset_after;
 
+        /** @brief The distance traveled by a truck from `i` to `j` */
+        double truck_distance(const std::size_t &i, const std::size_t &j) const
+        {
+            return truck_distances[i][j] * truck_distance_scale;
+        }
+
+        /** @brief Seconds elapsed since the problem was loaded */
+        double elapsed() const
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - _loaded_at).count();
+        }
+
+        /**
+         * @brief Whether the tabu search must stop, either to leave the remaining time to
+         * post-optimization or because a stop was requested (see `utils::Interruption`)
+         */
+        bool search_stopped() const
+        {
+            return utils::Interruption::requested() || (time_limit > 0 && elapsed() >= SEARCH_TIME_FRACTION * time_limit);
+        }
+
+        /** @brief Whether the whole time limit has elapsed or a stop was requested */
+        bool stopped() const
+        {
+            return utils::Interruption::requested() || (time_limit > 0 && elapsed() >= time_limit);
+        }
+
         static Problem *get_instance();
+        static Problem *load(const int argc, const char *const argv[]);
+        static std::string usage(const char *program);
     };
 
     Problem *Problem::_instance = nullptr;
@@ -171,28 +378,6 @@ namespace d2d
                 customers.emplace_back(x[i], y[i], demands[i], dronable[i], truck_service_time[i], drone_service_time[i]);
             }
 
-            std::vector<std::vector<double>> distances(customers.size(), std::vector<double>(customers.size()));
-            for (std::size_t i = 0; i < customers.size(); i++)
-            {
-                for (std::size_t j = i + 1; j < customers.size(); j++)
-                {
-                    distances[i][j] = distances[j][i] = utils::distance(
-                        customers[i].x - customers[j].x,
-                        customers[i].y - customers[j].y);
-                }
-            }
-
-            double average_distance = 0;
-            for (std::size_t i = 0; i < customers.size(); i++)
-            {
-                for (std::size_t j = i + 1; j < customers.size(); j++)
-                {
-                    average_distance += distances[i][j];
-                }
-            }
-
-            average_distance /= customers.size() * (customers.size() - 1) / 2;
-
             double tabu_size_factor;
             bool verbose;
             std::cin >> tabu_size_factor >> verbose;
@@ -283,7 +468,14 @@ namespace d2d
 
             int fix_iteration;
             std::size_t max_elite_size, reset_after_factor, destroy_rate;
-            std::cin >> fix_iteration >> max_elite_size >> reset_after_factor >> destroy_rate;
+            double time_limit;
+            std::cin >> fix_iteration >> max_elite_size >> reset_after_factor >> destroy_rate >> time_limit;
+
+            std::string scan_policy;
+            double sample_rate, critical_focus;
+            std::size_t critical_period;
+            double gap_limit, stagnation_gain, stagnation_spread;
+            std::cin >> scan_policy >> sample_rate >> critical_focus >> critical_period >> gap_limit >> stagnation_gain >> stagnation_spread;
 
             bool has_evaluate;
             std::optional<std::pair<std::vector<std::vector<std::vector<std::size_t>>>, std::vector<std::vector<std::vector<std::size_t>>>>> evaluate;
@@ -325,7 +517,8 @@ namespace d2d
                 evaluate = std::make_pair(truck_routes, drone_routes);
             }
 
-            _instance = new Problem(
+            auto [distances, average_distance] = InstanceData::euclidean_distances(x, y);
+            _instance = _create(
                 tabu_size_factor,
                 verbose,
                 trucks_count,
@@ -333,26 +526,579 @@ namespace d2d
                 waiting_time_limit,
                 customers,
                 distances,
+                distances,
+                1.0,
                 average_distance,
-                std::accumulate(
-                    customers.begin(), customers.end(), 0.0,
-                    [](const double &sum, const Customer &customer)
-                    { return sum + customer.demand; }),
                 truck,
                 drone,
-                dynamic_cast<DroneLinearConfig *>(drone),
-                dynamic_cast<DroneNonlinearConfig *>(drone),
-                dynamic_cast<DroneEnduranceConfig *>(drone),
                 strategy,
                 fix_iteration,
                 reset_after_factor,
                 max_elite_size,
                 destroy_rate,
+                time_limit,
+                scan_policy,
+                sample_rate,
+                critical_focus,
+                critical_period,
+                gap_limit,
+                stagnation_gain,
+                stagnation_spread,
+                "",
+                "",
+                "",
+                "",
+                0,
+                "",
                 evaluate);
         }
 
         return _instance;
     }
+
+    Problem *Problem::_create(
+        const double &tabu_size_factor,
+        const bool verbose,
+        const std::size_t &trucks_count,
+        const std::size_t &drones_count,
+        const double &waiting_time_limit,
+        const std::vector<Customer> &customers,
+        const utils::SquareMatrix<double> &distances,
+        const utils::SquareMatrix<double> &truck_distances,
+        const double &truck_distance_scale,
+        const double &average_distance,
+        const TruckConfig *const truck,
+        const _BaseDroneConfig *const drone,
+        const std::string &strategy,
+        const int &fix_iteration,
+        const std::size_t &reset_after_factor,
+        const std::size_t &max_elite_size,
+        const std::size_t &destroy_rate,
+        const double &time_limit,
+        const std::string &scan_policy,
+        const double &sample_rate,
+        const double &critical_focus,
+        const std::size_t &critical_period,
+        const double &gap_limit,
+        const double &stagnation_gain,
+        const double &stagnation_spread,
+        const std::string &name,
+        const std::string &trace_path,
+        const std::string &output_path,
+        const std::string &profile_path,
+        const int &profile_level,
+        const std::string &control_path,
+        const std::optional<std::pair<std::vector<std::vector<std::vector<std::size_t>>>, std::vector<std::vector<std::vector<std::size_t>>>>> &evaluate)
+    {
+        return new Problem(
+            tabu_size_factor,
+            verbose,
+            trucks_count,
+            drones_count,
+            waiting_time_limit,
+            customers,
+            distances,
+            truck_distances,
+            truck_distance_scale,
+            average_distance,
+            std::accumulate(
+                customers.begin(), customers.end(), 0.0,
+                [](const double &sum, const Customer &customer)
+                { return sum + customer.demand; }),
+            truck,
+            drone,
+            dynamic_cast<const DroneLinearConfig *>(drone),
+            dynamic_cast<const DroneNonlinearConfig *>(drone),
+            dynamic_cast<const DroneEnduranceConfig *>(drone),
+            strategy,
+            fix_iteration,
+            reset_after_factor,
+            max_elite_size,
+            destroy_rate,
+            time_limit,
+            scan_policy,
+            sample_rate,
+            critical_focus,
+            critical_period,
+            gap_limit,
+            stagnation_gain,
+            stagnation_spread,
+            name,
+            trace_path,
+            output_path,
+            profile_path,
+            profile_level,
+            control_path,
+            evaluate);
+    }
+
+    /** @brief The usage of the command line options of `Problem::load` */
+    std::string Problem::usage(const char *program)
+    {
+        return utils::format(
+            "usage: %s [-h] [-t TABU_SIZE_FACTOR] [-c {linear,non-linear,endurance,unlimited}] [--speed-type {low,high}]\n"
+            "       [--range-type {low,high}] [--trucks-count TRUCKS_COUNT] [--drones-count DRONES_COUNT]\n"
+            "       [--waiting-time-limit WAITING_TIME_LIMIT] [--strategy {random,cyclic,vns,adaptive}]\n"
+            "       [--fix-iteration FIX_ITERATION] [--reset-after-factor RESET_AFTER_FACTOR] [--max-elite-size MAX_ELITE_SIZE]\n"
+            "       [--destroy-rate DESTROY_RATE] [--time-limit TIME_LIMIT] [--scan-policy {auto,best,first,sampled}]\n"
+            "       [--sample-rate SAMPLE_RATE] [--critical-focus EPSILON] [--critical-period CRITICAL_PERIOD]\n"
+            "       [--gap-limit GAP_LIMIT] [--stagnation-gain STAGNATION_GAIN] [--stagnation-spread STAGNATION_SPREAD]\n"
+            "       [--config-dir CONFIG_DIR] [--truck-distances PATH | --truck-travel-times PATH]\n"
+            "       [--trace PATH] [--output PATH] [--profile PATH] [--profile-level {1,2,3}] [--control PATH]\n"
+            "       [--seed SEED] [-v] problem\n",
+            program);
+    }
+
+    /**
+     * @brief Load the problem directly from a data file and the JSON configuration files, without
+     * going through `scripts/in.py`.
+     *
+     * The command line options are the same as `scripts/in.py`, with an additional `--config-dir`
+     * to locate the JSON configuration files, and `--truck-distances` or `--truck-travel-times` to
+     * provide a road matrix for trucks (drones always fly straight), `--trace` to stream a
+     * per-iteration search trace to a file, `--output` to write the result as JSON lines
+     * instead of the text output, `--profile` (with `--profile-level`) to record an
+     * instrumentation trace, `--control` to poll a control file for a "stop" line and `--seed` to make
+     * the search reproducible. The problem argument is either a
+     * path to a data file (text, or binary as produced by `convert.exe`) or a problem name in
+     * `problems/data`.
+     *
+     * @param argc The number of command line arguments
+     * @param argv The command line arguments
+     * @return The problem instance
+     */
+    Problem *Problem::load(const int argc, const char *const argv[])
+    {
+        if (_instance != nullptr)
+        {
+            return _instance;
+        }
+
+        std::string problem;
+        double tabu_size_factor = 1.0;
+        std::string config = "endurance";
+        std::string speed_type = "high", range_type = "high";
+        int trucks_count_override = -1, drones_count_override = -1;
+        double waiting_time_limit = 3600;
+        std::string strategy = "random";
+        int fix_iteration = -1;
+        std::size_t reset_after_factor = 30, max_elite_size = 10, destroy_rate = 0;
+        double time_limit = -1;
+        std::string scan_policy = "auto";
+        double sample_rate = 0.25;
+        double critical_focus = -1;
+        std::size_t critical_period = 10;
+        double gap_limit = -1;
+        double stagnation_gain = -1, stagnation_spread = 1;
+        std::string config_dir = "problems/config_parameter";
+        std::string truck_matrix;
+        std::string trace_path;
+        std::string output_path;
+        std::string profile_path;
+        int profile_level = utils::Instrumentation::PHASES;
+        std::string control_path;
+        std::optional<std::uint32_t> seed;
+        bool truck_travel_times = false;
+        bool verbose = false;
+
+        auto check_choice = [](const std::string_view &option, const std::string &value, const std::vector<std::string> &choices)
+        {
+            if (std::find(choices.begin(), choices.end(), value) == choices.end())
+            {
+                throw std::invalid_argument(utils::format("Invalid choice \"%s\" for %s", value.c_str(), std::string(option).c_str()));
+            }
+        };
+
+        for (int i = 1; i < argc; i++)
+        {
+            std::string_view argument = argv[i], option = argument;
+            std::optional<std::string_view> inline_value;
+            if (argument.substr(0, 2) == "--")
+            {
+                auto equal = argument.find('=');
+                if (equal != std::string_view::npos)
+                {
+                    option = argument.substr(0, equal);
+                    inline_value = argument.substr(equal + 1);
+                }
+            }
+
+            auto value = [&]() -> std::string
+            {
+                if (inline_value.has_value())
+                {
+                    return std::string(inline_value.value());
+                }
+
+                if (i + 1 >= argc)
+                {
+                    throw std::invalid_argument(utils::format("Option %s expects a value", std::string(option).c_str()));
+                }
+
+                return argv[++i];
+            };
+
+            if (option == "-h" || option == "--help")
+            {
+                std::cerr << usage(argv[0]);
+                std::exit(0);
+            }
+            else if (option == "-v" || option == "--verbose")
+            {
+                verbose = true;
+            }
+            else if (option == "-t" || option == "--tabu-size-factor")
+            {
+                tabu_size_factor = utils::parse_number<double>(value());
+            }
+            else if (option == "-c" || option == "--config")
+            {
+                config = value();
+                check_choice(option, config, {"linear", "non-linear", "endurance", "unlimited"});
+            }
+            else if (option == "--speed-type")
+            {
+                speed_type = value();
+                check_choice(option, speed_type, {"low", "high"});
+            }
+            else if (option == "--range-type")
+            {
+                range_type = value();
+                check_choice(option, range_type, {"low", "high"});
+            }
+            else if (option == "--trucks-count")
+            {
+                trucks_count_override = utils::parse_number<int>(value());
+            }
+            else if (option == "--drones-count")
+            {
+                drones_count_override = utils::parse_number<int>(value());
+            }
+            else if (option == "--waiting-time-limit")
+            {
+                waiting_time_limit = utils::parse_number<double>(value());
+            }
+            else if (option == "--strategy")
+            {
+                strategy = value();
+                check_choice(option, strategy, {"random", "cyclic", "vns", "adaptive"});
+            }
+            else if (option == "--fix-iteration")
+            {
+                fix_iteration = utils::parse_number<int>(value());
+            }
+            else if (option == "--reset-after-factor")
+            {
+                reset_after_factor = utils::parse_number<std::size_t>(value());
+            }
+            else if (option == "--max-elite-size")
+            {
+                max_elite_size = utils::parse_number<std::size_t>(value());
+            }
+            else if (option == "--destroy-rate")
+            {
+                destroy_rate = utils::parse_number<std::size_t>(value());
+            }
+            else if (option == "--time-limit")
+            {
+                time_limit = utils::parse_number<double>(value());
+            }
+            else if (option == "--scan-policy")
+            {
+                scan_policy = value();
+                check_choice(option, scan_policy, {"auto", "best", "first", "sampled"});
+            }
+            else if (option == "--sample-rate")
+            {
+                sample_rate = utils::parse_number<double>(value());
+                if (sample_rate <= 0 || sample_rate > 1)
+                {
+                    throw std::invalid_argument(utils::format("--sample-rate must be in (0, 1], got %lf", sample_rate));
+                }
+            }
+            else if (option == "--critical-focus")
+            {
+                critical_focus = utils::parse_number<double>(value());
+            }
+            else if (option == "--critical-period")
+            {
+                critical_period = utils::parse_number<std::size_t>(value());
+                if (critical_period == 0)
+                {
+                    throw std::invalid_argument("--critical-period must be positive");
+                }
+            }
+            else if (option == "--gap-limit")
+            {
+                gap_limit = utils::parse_number<double>(value());
+            }
+            else if (option == "--stagnation-gain")
+            {
+                stagnation_gain = utils::parse_number<double>(value());
+            }
+            else if (option == "--stagnation-spread")
+            {
+                stagnation_spread = utils::parse_number<double>(value());
+            }
+            else if (option == "--config-dir")
+            {
+                config_dir = value();
+            }
+            else if (option == "--trace")
+            {
+                trace_path = value();
+            }
+            else if (option == "--output")
+            {
+                output_path = value();
+            }
+            else if (option == "--profile")
+            {
+                profile_path = value();
+            }
+            else if (option == "--profile-level")
+            {
+                profile_level = utils::parse_number<int>(value());
+                if (profile_level < utils::Instrumentation::PHASES || profile_level > utils::Instrumentation::DETAILS)
+                {
+                    throw std::invalid_argument(utils::format("Invalid choice %d for --profile-level", profile_level));
+                }
+            }
+            else if (option == "--control")
+            {
+                control_path = value();
+            }
+            else if (option == "--seed")
+            {
+                seed = utils::parse_number<std::uint32_t>(value());
+            }
+            else if (option == "--truck-distances" || option == "--truck-travel-times")
+            {
+                truck_matrix = value();
+                truck_travel_times = option == "--truck-travel-times";
+            }
+            else if (argument.size() > 1 && argument[0] == '-')
+            {
+                throw std::invalid_argument(utils::format("Unrecognized option %s", argv[i]));
+            }
+            else if (problem.empty())
+            {
+                problem = argument;
+            }
+            else
+            {
+                throw std::invalid_argument(utils::format("Unexpected argument %s", argv[i]));
+            }
+        }
+
+        if (problem.empty())
+        {
+            throw std::invalid_argument("The problem argument is required");
+        }
+
+        if (seed.has_value())
+        {
+            utils::rng.seed(seed.value());
+        }
+
+        // The problem is either a data file path or a name in problems/data
+        std::error_code error;
+        std::string path = problem;
+        if (!std::filesystem::is_regular_file(path, error))
+        {
+            if (path.size() >= 4 && path.compare(path.size() - 4, 4, ".txt") == 0)
+            {
+                path.resize(path.size() - 4);
+            }
+
+            path = "problems/data/" + path + ".txt";
+            if (!std::filesystem::is_regular_file(path, error))
+            {
+                throw std::invalid_argument(utils::format("Problem %s not found, neither as a file nor in problems/data", problem.c_str()));
+            }
+        }
+
+        if (!std::ifstream(path).good())
+        {
+            throw std::runtime_error(utils::format("Unable to read \"%s\"", path.c_str()));
+        }
+
+        // The problem name is the data file name without directory and extension
+        std::string name = path.substr(path.find_last_of("/\\") + 1);
+        name = name.substr(0, name.find_last_of('.'));
+
+        // Problem data file, either in text or binary format
+        auto instance = InstanceData::read(path);
+        const std::size_t customers_count = instance.customers_count();
+        std::size_t trucks_count = instance.trucks_count, drones_count = instance.drones_count;
+
+        if (trucks_count_override > 0)
+        {
+            trucks_count = trucks_count_override;
+        }
+        if (drones_count_override > 0)
+        {
+            drones_count = drones_count_override;
+        }
+
+        // Truck configuration
+        TruckConfig *truck;
+        {
+            utils::MappedFile file(config_dir + "/truck_config.json");
+            auto data = utils::JSON::parse(file.view());
+
+            std::vector<double> coefficients;
+            for (auto &[_, coefficient] : data["T (hour)"].object())
+            {
+                coefficients.push_back(coefficient.number());
+            }
+
+            truck = new TruckConfig(data["V_max (m/s)"].number(), coefficients, data["M_t (kg)"].number());
+        }
+
+        // Drone configuration
+        _BaseDroneConfig *drone = nullptr;
+        double endurance_range = std::numeric_limits<double>::infinity();
+        {
+            const std::string filename = config == "linear"       ? "drone_linear_config.json"
+                                         : config == "non-linear" ? "drone_nonlinear_config.json"
+                                                                  : "drone_endurance_config.json";
+
+            utils::MappedFile file(config_dir + "/" + filename);
+            auto data = utils::JSON::parse(file.view());
+            for (auto &[_, model] : data.object())
+            {
+                // drone_nonlinear_config.json stores the shared coefficients next to the models
+                if (model.type() != utils::JSON::Type::object || model["speed_type"].string() != speed_type || model["range"].string() != range_type)
+                {
+                    continue;
+                }
+
+                const double capacity = model["capacity [kg]"].number();
+                const StatsType _speed_type = speed_type == "low" ? StatsType::low : StatsType::high,
+                                _range_type = range_type == "low" ? StatsType::low : StatsType::high;
+                if (config == "linear")
+                {
+                    drone = new DroneLinearConfig(
+                        capacity,
+                        _speed_type,
+                        _range_type,
+                        model["takeoffSpeed [m/s]"].number(),
+                        model["cruiseSpeed [m/s]"].number(),
+                        model["landingSpeed [m/s]"].number(),
+                        model["cruiseAlt [m]"].number(),
+                        model["batteryPower [Joule]"].number(),
+                        model["beta(w/kg)"].number(),
+                        model["gamma(w)"].number());
+                }
+                else if (config == "non-linear")
+                {
+                    drone = new DroneNonlinearConfig(
+                        capacity,
+                        _speed_type,
+                        _range_type,
+                        model["takeoffSpeed [m/s]"].number(),
+                        model["cruiseSpeed [m/s]"].number(),
+                        model["landingSpeed [m/s]"].number(),
+                        model["cruiseAlt [m]"].number(),
+                        model["batteryPower [Joule]"].number(),
+                        data["k1"].number(),
+                        data["k2 (sqrt(kg/m))"].number(),
+                        data["c1 (sqrt(m/kg))"].number(),
+                        data["c2 (sqrt(m/kg))"].number(),
+                        data["c4 (kg/m)"].number(),
+                        data["c5 (Ns/m)"].number());
+                }
+                else
+                {
+                    const double fixed_time = model["FixedTime (s)"].number(), drone_speed = model["V_max (m/s)"].number();
+                    endurance_range = fixed_time * drone_speed;
+                    drone = new DroneEnduranceConfig(
+                        capacity,
+                        _speed_type,
+                        _range_type,
+                        config == "endurance" ? fixed_time : 1e9,
+                        drone_speed);
+                }
+
+                break;
+            }
+
+            if (drone == nullptr)
+            {
+                delete truck;
+                throw std::runtime_error(utils::format("Cannot find a satisfying model from %s", filename.c_str()));
+            }
+        }
+
+        const auto &x = instance.x, &y = instance.y, &demands = instance.demands;
+        std::vector<Customer> customers;
+        for (std::size_t i = 0; i < customers_count + 1; i++)
+        {
+            bool dronable = i == 0 || (instance.dronable[i] && demands[i] <= drone->capacity && 2 * utils::distance(x[i], y[i]) <= endurance_range);
+            customers.emplace_back(x[i], y[i], demands[i], dronable, instance.truck_service_time[i], instance.drone_service_time[i]);
+        }
+
+        if (!instance.distances.has_value())
+        {
+            std::tie(instance.distances, instance.average_distance) = InstanceData::euclidean_distances(x, y);
+        }
+
+        std::optional<utils::SquareMatrix<double>> truck_distances;
+        double truck_distance_scale = 1;
+        if (!truck_matrix.empty())
+        {
+            truck_distances = InstanceData::read_matrix(truck_matrix);
+            if (truck_distances->size() != customers.size())
+            {
+                throw std::runtime_error(utils::format("Expected a %lux%lu matrix in %s", customers.size(), customers.size(), truck_matrix.c_str()));
+            }
+
+            if (truck_travel_times)
+            {
+                // Travel times are measured at the maximum truck velocity. The matrix is kept as read and
+                // `truck_distance` multiplies its entries by this factor to get the equivalent distances,
+                // so that the time-of-day speed coefficients still apply.
+                truck_distance_scale = truck->maximum_speed();
+            }
+        }
+
+        _instance = _create(
+            tabu_size_factor,
+            verbose,
+            trucks_count,
+            drones_count,
+            waiting_time_limit,
+            customers,
+            instance.distances.value(),
+            truck_distances.value_or(instance.distances.value()),
+            truck_distance_scale,
+            instance.average_distance,
+            truck,
+            drone,
+            strategy,
+            fix_iteration,
+            fix_iteration < 0 ? reset_after_factor : fix_iteration,
+            max_elite_size,
+            destroy_rate,
+            time_limit,
+            scan_policy,
+            sample_rate,
+            critical_focus,
+            critical_period,
+            gap_limit,
+            stagnation_gain,
+            stagnation_spread,
+            name,
+            trace_path,
+            output_path,
+            profile_path,
+            profile_level,
+            control_path,
+            std::nullopt);
+
+        return _instance;
+    }
 }
 
 namespace std
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "utils.hpp"
+
+namespace utils
+{
+    /**
+     * @brief A bounded lock-free queue for exactly one producer thread and one consumer thread.
+     *
+     * @tparam T A trivially copyable element type
+     */
+    template <typename T, std::enable_if_t<std::is_trivially_copyable_v<T>, bool> = true>
+    class SPSCRingBuffer
+    {
+    private:
+        std::vector<T> _buffer;
+        const std::size_t _mask;
+
+        // Keep the indices on separate cache lines so that both threads do not contend on them
+        alignas(64) std::atomic<std::size_t> _head = 0; // Next slot to write, only modified by the producer
+        alignas(64) std::atomic<std::size_t> _tail = 0; // Next slot to read, only modified by the consumer
+
+        static std::size_t _round_up(const std::size_t &capacity)
+        {
+            std::size_t result = 1;
+            while (result < capacity)
+            {
+                result <<= 1;
+            }
+
+            return result;
+        }
+
+    public:
+        /**
+         * @brief Construct a new SPSCRingBuffer object.
+         *
+         * @param capacity The minimum number of elements the buffer can hold, rounded up to a power of 2
+         */
+        SPSCRingBuffer(const std::size_t &capacity) : _buffer(_round_up(capacity)), _mask(_buffer.size() - 1) {}
+
+        SPSCRingBuffer(const SPSCRingBuffer &) = delete;
+        SPSCRingBuffer &operator=(const SPSCRingBuffer &) = delete;
+
+        std::size_t capacity() const
+        {
+            return _buffer.size();
+        }
+
+        /**
+         * @brief Append an element, called from the producer thread only.
+         *
+         * @return `false` if the buffer is full
+         */
+        bool try_push(const T &value)
+        {
+            auto head = _head.load(std::memory_order_relaxed);
+            if (head - _tail.load(std::memory_order_acquire) == _buffer.size())
+            {
+                return false;
+            }
+
+            _buffer[head & _mask] = value;
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Remove the oldest element, called from the consumer thread only.
+         *
+         * @return `false` if the buffer is empty
+         */
+        bool try_pop(T &value)
+        {
+            auto tail = _tail.load(std::memory_order_relaxed);
+            if (tail == _head.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+
+            value = _buffer[tail & _mask];
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+    };
+}
@@ -1,22 +1,81 @@
 #pragma once
 
 #include "errors.hpp"
+#include "pool.hpp"
 #include "problem.hpp"
 
 #define ONE_HOUR 3600.0
 
 namespace d2d
 {
+    /**
+     * @brief Prefix aggregates over the customers of a route, answering queries over a segment
+     * `[first, last)` of customer indices in constant time.
+     */
+    class RouteAggregates
+    {
+    private:
+        // `_demand[i]` is the total demand of the first `i` customers
+        std::vector<double> _demand;
+
+        // `_non_dronable[i]` is the number of customers among the first `i` that drones cannot serve
+        std::vector<std::size_t> _non_dronable;
+
+    public:
+        explicit RouteAggregates(const std::vector<std::size_t> &customers)
+            : _demand(utils::RecycleBin<std::vector<double>>::acquire()),
+              _non_dronable(utils::RecycleBin<std::vector<std::size_t>>::acquire())
+        {
+            auto problem = Problem::get_instance();
+            _demand.resize(customers.size() + 1);
+            _non_dronable.resize(customers.size() + 1);
+            _demand[0] = _non_dronable[0] = 0;
+            for (std::size_t i = 0; i < customers.size(); i++)
+            {
+                _demand[i + 1] = _demand[i] + problem->columns.demand[customers[i]];
+                _non_dronable[i + 1] = _non_dronable[i] + !problem->columns.dronable[customers[i]];
+            }
+        }
+
+        ~RouteAggregates()
+        {
+            utils::RecycleBin<std::vector<double>>::release(std::move(_demand));
+            utils::RecycleBin<std::vector<std::size_t>>::release(std::move(_non_dronable));
+        }
+
+        /** @brief The allocated memory, see `utils::heap_size` */
+        std::size_t heap_size() const
+        {
+            return sizeof(RouteAggregates) + utils::heap_size(_demand) + utils::heap_size(_non_dronable);
+        }
+
+        /** @brief Total demand of the customers in `[first, last)` */
+        double demand(const std::size_t &first, const std::size_t &last) const
+        {
+            return _demand[last] - _demand[first];
+        }
+
+        /** @brief Whether drones can serve all customers in `[first, last)` */
+        bool dronable(const std::size_t &first, const std::size_t &last) const
+        {
+            return _non_dronable[last] == _non_dronable[first];
+        }
+    };
+
     class _BaseRoute
     {
     protected:
-        static double _calculate_distance(const std::vector<std::size_t> &customers);
+        static double _calculate_distance(const std::vector<std::size_t> &customers, const utils::SquareMatrix<double> &distances);
         static double _calculate_weight(const std::vector<std::size_t> &customers);
 
         std::vector<std::size_t> _customers;
         double _distance;
         double _weight;
 
+        // Built on the first query, since most routes belong to rejected candidates and are never
+        // scanned. Shared by the copies of this route made afterwards.
+        mutable std::shared_ptr<const RouteAggregates> _aggregates;
+
         _BaseRoute(
             const std::vector<std::size_t> &customers,
             const double &distance,
@@ -39,14 +98,24 @@ namespace d2d
         }
 
     public:
+        template <typename _ServiceTime>
         static std::vector<double> calculate_waiting_time_violations(
             const std::vector<std::size_t> &customers,
             const std::vector<double> &time_segments,
-            const std::function<double(const std::size_t &)> &service_time);
+            const _ServiceTime &service_time);
 
         /** @brief The amount of weight exceeding vehicle capacity. */
         virtual double capacity_violation() const = 0;
 
+        /**
+         * @brief The allocated memory, see `utils::heap_size`. The aggregates are counted although
+         * the copies of this route share them.
+         */
+        std::size_t heap_size() const
+        {
+            return utils::heap_size(_customers) + (_aggregates == nullptr ? 0 : _aggregates->heap_size());
+        }
+
         /**
          * @brief The order of customers in this route, starting and ending at the depot `0`.
          */
@@ -70,15 +139,30 @@ namespace d2d
         {
             return _weight;
         }
+
+        /**
+         * @brief Prefix aggregates of this route, for segment queries over its customers.
+         *
+         * The aggregates are built by the first call, which is not synchronized: a route must not
+         * be queried from several threads before that.
+         */
+        const RouteAggregates &aggregates() const
+        {
+            if (_aggregates == nullptr)
+            {
+                _aggregates = std::allocate_shared<RouteAggregates>(utils::PoolAllocator<RouteAggregates>(), _customers);
+            }
+
+            return *_aggregates;
+        }
     };
 
-    double _BaseRoute::_calculate_distance(const std::vector<std::size_t> &customers)
+    double _BaseRoute::_calculate_distance(const std::vector<std::size_t> &customers, const utils::SquareMatrix<double> &distances)
     {
-        auto problem = Problem::get_instance();
         double distance = 0;
         for (std::size_t i = 1; i < customers.size(); i++)
         {
-            distance += problem->distances[customers[i - 1]][customers[i]];
+            distance += distances[customers[i - 1]][customers[i]];
         }
 
         return distance;
@@ -90,16 +174,17 @@ namespace d2d
         double weight = 0;
         for (auto &customer : customers)
         {
-            weight += problem->customers[customer].demand;
+            weight += problem->columns.demand[customer];
         }
 
         return weight;
     }
 
+    template <typename _ServiceTime>
     std::vector<double> _BaseRoute::calculate_waiting_time_violations(
         const std::vector<std::size_t> &customers,
         const std::vector<double> &time_segments,
-        const std::function<double(const std::size_t &)> &service_time)
+        const _ServiceTime &service_time)
     {
         auto problem = Problem::get_instance();
         std::vector<double> violations(customers.size());
@@ -124,6 +209,14 @@ namespace d2d
             const std::vector<std::size_t> &customers,
             std::size_t &coefficients_index,
             double &current_within_timespan);
+
+        /** @brief Same as above, but reuse the storage of `time_segments` for the result */
+        static void calculate_time_segments(
+            const std::vector<std::size_t> &customers,
+            std::size_t &coefficients_index,
+            double &current_within_timespan,
+            std::vector<double> &time_segments);
+
         static std::vector<double> calculate_waiting_time_violations(
             const std::vector<std::size_t> &customers,
             const std::vector<double> &time_segments);
@@ -137,7 +230,10 @@ namespace d2d
 
         /** @brief Construct a `TruckRoute` from a list of customers in order. */
         TruckRoute(const std::vector<std::size_t> &customers)
-            : TruckRoute(customers, _calculate_distance(customers), _calculate_weight(customers)) {}
+            : TruckRoute(
+                  customers,
+                  _calculate_distance(customers, Problem::get_instance()->truck_distances) * Problem::get_instance()->truck_distance_scale,
+                  _calculate_weight(customers)) {}
 
         double capacity_violation() const override
         {
@@ -170,8 +266,19 @@ namespace d2d
         std::size_t &coefficients_index,
         double &current_within_timespan)
     {
-        auto problem = Problem::get_instance();
         std::vector<double> time_segments;
+        calculate_time_segments(customers, coefficients_index, current_within_timespan, time_segments);
+        return time_segments;
+    }
+
+    void TruckRoute::calculate_time_segments(
+        const std::vector<std::size_t> &customers,
+        std::size_t &coefficients_index,
+        double &current_within_timespan,
+        std::vector<double> &time_segments)
+    {
+        auto problem = Problem::get_instance();
+        time_segments.clear();
 
         const auto shift = [&coefficients_index, &current_within_timespan](double *time_segment_ptr, double dt)
         {
@@ -187,9 +294,9 @@ namespace d2d
         time_segments.reserve(customers.size() - 1);
         for (std::size_t i = 0; i + 1 < customers.size(); i++)
         {
-            double time_segment = 0, distance = problem->distances[customers[i]][customers[i + 1]];
+            double time_segment = 0, distance = problem->truck_distance(customers[i], customers[i + 1]);
 
-            shift(&time_segment, problem->customers[customers[i]].truck_service_time);
+            shift(&time_segment, problem->columns.truck_service_time[customers[i]]);
             while (distance > 0)
             {
                 double speed = problem->truck->speed(coefficients_index),
@@ -201,8 +308,6 @@ namespace d2d
 
             time_segments.push_back(time_segment);
         }
-
-        return time_segments;
     }
 
     std::vector<double> TruckRoute::calculate_waiting_time_violations(
@@ -215,7 +320,7 @@ namespace d2d
             time_segments,
             [&problem](const std::size_t &customer)
             {
-                return problem->customers[customer].truck_service_time;
+                return problem->columns.truck_service_time[customer];
             });
     }
 
@@ -257,7 +362,7 @@ namespace d2d
             auto problem = Problem::get_instance();
             for (auto &customer : customers)
             {
-                if (!problem->customers[customer].dronable)
+                if (!problem->columns.dronable[customer])
                 {
                     throw NonDronable(customer);
                 }
@@ -291,7 +396,7 @@ namespace d2d
             : DroneRoute(
                   customers,
                   time_segments,
-                  _calculate_distance(customers),
+                  _calculate_distance(customers, Problem::get_instance()->distances),
                   _calculate_weight(customers),
                   _calculate_energy_consumption(customers)) {}
 
@@ -402,7 +507,7 @@ namespace d2d
         for (std::size_t i = 0; i + 1 < customers.size(); i++)
         {
             time_segments.push_back(
-                problem->customers[customers[i]].drone_service_time +
+                problem->columns.drone_service_time[customers[i]] +
                 drone->takeoff_time() +
                 drone->cruise_time(problem->distances[customers[i]][customers[i + 1]]) +
                 drone->landing_time());
@@ -421,7 +526,7 @@ namespace d2d
             time_segments,
             [&problem](const std::size_t &customer)
             {
-                return problem->customers[customer].drone_service_time;
+                return problem->columns.drone_service_time[customer];
             });
     }
 
@@ -433,7 +538,7 @@ namespace d2d
         auto drone = problem->drone;
         for (std::size_t i = 0; i + 1 < customers.size(); i++)
         {
-            weight += problem->customers[customers[i]].demand;
+            weight += problem->columns.demand[customers[i]];
             energy += drone->takeoff_time() * drone->takeoff_power(weight) +
                       drone->cruise_time(problem->distances[customers[i]][customers[i + 1]]) * drone->cruise_power(weight) +
                       drone->landing_time() * drone->landing_power(weight);
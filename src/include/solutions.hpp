@@ -1,13 +1,19 @@
 #pragma once
 
+#include "adaptive.hpp"
 #include "bitvector.hpp"
 #include "tsp_solver.hpp"
 #include "fp_specifier.hpp"
 #include "initial.hpp"
+#include "instrument.hpp"
 #include "logger.hpp"
+#include "lower_bound.hpp"
 #include "parent.hpp"
+#include "pool.hpp"
 #include "problem.hpp"
 #include "routes.hpp"
+#include "stagnation.hpp"
+#include "thread_pool.hpp"
 #include "wrapper.hpp"
 #include "neighborhoods/cross_3.hpp"
 #include "neighborhoods/cross.hpp"
@@ -25,7 +31,7 @@ namespace d2d
 
         static const std::vector<std::shared_ptr<Neighborhood<Solution, true>>> _neighborhoods;
 
-        static std::vector<std::vector<std::vector<double>>> _calculate_truck_time_segments(
+        static const std::vector<std::vector<std::vector<double>>> &_calculate_truck_time_segments(
             const std::vector<std::vector<TruckRoute>> &truck_routes);
         static std::vector<double> _calculate_truck_working_time(
             const std::vector<std::vector<std::vector<double>>> &truck_time_segments);
@@ -44,10 +50,49 @@ namespace d2d
             const std::vector<std::vector<DroneRoute>> &drone_routes);
         static double _calculate_fixed_time_violation(const std::vector<std::vector<DroneRoute>> &drone_routes);
 
-        const std::vector<std::vector<std::vector<double>>> _temp_truck_time_segments;
+        // Routes with fewer customers (including the depot) are reordered by Held-Karp, others by 2-opt
+        static constexpr std::size_t _HELD_KARP_LIMIT = 23;
+
+        // Held-Karp tables up to this size are built concurrently by the post-optimization tasks, larger
+        // ones are built one at a time on the calling thread
+        static constexpr std::size_t _CONCURRENT_TSP_MEMORY = 64 << 20;
+
+        template <typename RT, std::enable_if_t<is_route_v<RT>, bool> = true>
+        static RT _tsp_optimize(const RT &route);
+
+        /** @brief Whether `_tsp_optimize(route)` may run concurrently with other routes */
+        template <typename RT, std::enable_if_t<is_route_v<RT>, bool> = true>
+        static bool _tsp_concurrent(const RT &route)
+        {
+            const auto n = route.customers().size() - 1;
+            return n >= _HELD_KARP_LIMIT || utils::held_karp_memory(n) <= _CONCURRENT_TSP_MEMORY;
+        }
 
         const std::shared_ptr<ParentInfo<Solution>> _parent;
 
+        // Not const, so that `~Solution` can hand the storage over to the recycle bins
+        std::vector<double> _truck_working_time;
+        std::vector<double> _drone_working_time;
+        std::vector<std::vector<TruckRoute>> _truck_routes;
+        std::vector<std::vector<DroneRoute>> _drone_routes;
+
+        /**
+         * @brief Copy the routes of all vehicles into storage recycled from discarded solutions,
+         * see `~Solution`
+         */
+        template <typename RT, std::enable_if_t<is_route_v<RT>, bool> = true>
+        static std::vector<std::vector<RT>> _copy_routes(const std::vector<std::vector<RT>> &vehicle_routes)
+        {
+            auto result = utils::RecycleBin<std::vector<std::vector<RT>>>::acquire();
+            result.resize(vehicle_routes.size());
+            for (std::size_t i = 0; i < vehicle_routes.size(); i++)
+            {
+                result[i].assign(vehicle_routes[i].begin(), vehicle_routes[i].end());
+            }
+
+            return result;
+        }
+
         template <typename RT, std::enable_if_t<is_route_v<RT>, bool> = true>
         void _hamming_distance(const std::vector<std::vector<RT>> &vehicle_routes, std::vector<std::size_t> &repr) const
         {
@@ -72,11 +117,8 @@ namespace d2d
         static std::array<double, 4> penalty_coefficients();
         static std::vector<std::vector<double>> best_with_edges;
 
-        /** @brief Working time of truck routes */
-        const std::vector<double> truck_working_time;
-
-        /** @brief Working time of drone routes */
-        const std::vector<double> drone_working_time;
+        static VehicleEvaluation evaluate_vehicle(const std::vector<TruckRoute> &routes);
+        static VehicleEvaluation evaluate_vehicle(const std::vector<DroneRoute> &routes);
 
         /** @brief System working time */
         const double working_time;
@@ -93,31 +135,28 @@ namespace d2d
         /** @brief Total fixed time violation */
         const double fixed_time_violation;
 
-        /** @brief Routes of trucks */
-        const std::vector<std::vector<TruckRoute>> truck_routes;
-
-        /** @brief Routes of drones */
-        const std::vector<std::vector<DroneRoute>> drone_routes;
-
         /** @brief Solution feasibility */
         const bool feasible;
 
+    private:
+        // The truck time segments are only needed during construction, so they are computed in a
+        // reused buffer instead of being stored in every solution
         Solution(
             const std::vector<std::vector<TruckRoute>> &truck_routes,
             const std::vector<std::vector<DroneRoute>> &drone_routes,
+            const std::vector<std::vector<std::vector<double>>> &truck_time_segments,
             const std::shared_ptr<ParentInfo<Solution>> parent,
-            const bool debug_check = true)
-            : _temp_truck_time_segments(_calculate_truck_time_segments(truck_routes)),
-              _parent(parent),
-              truck_working_time(_calculate_truck_working_time(_temp_truck_time_segments)),
-              drone_working_time(_calculate_drone_working_time(drone_routes)),
-              working_time(_calculate_working_time(truck_working_time, drone_working_time)),
+            const bool debug_check)
+            : _parent(parent),
+              _truck_working_time(_calculate_truck_working_time(truck_time_segments)),
+              _drone_working_time(_calculate_drone_working_time(drone_routes)),
+              _truck_routes(_copy_routes(truck_routes)),
+              _drone_routes(_copy_routes(drone_routes)),
+              working_time(_calculate_working_time(_truck_working_time, _drone_working_time)),
               drone_energy_violation(_calculate_energy_violation(drone_routes)),
               capacity_violation(_calculate_capacity_violation(truck_routes, drone_routes)),
-              waiting_time_violation(_calculate_waiting_time_violation(truck_routes, _temp_truck_time_segments, drone_routes)),
+              waiting_time_violation(_calculate_waiting_time_violation(truck_routes, truck_time_segments, drone_routes)),
               fixed_time_violation(_calculate_fixed_time_violation(drone_routes)),
-              truck_routes(truck_routes),
-              drone_routes(drone_routes),
               feasible(
                   utils::approximate(drone_energy_violation, 0.0) &&
                   utils::approximate(capacity_violation, 0.0) &&
@@ -125,6 +164,7 @@ namespace d2d
                   utils::approximate(fixed_time_violation, 0.0))
         {
             const auto problem = Problem::get_instance();
+            _solutions_counter.add();
 
             if (feasible && debug_check)
             {
@@ -202,6 +242,63 @@ namespace d2d
             }
         }
 
+    public:
+        Solution(
+            const std::vector<std::vector<TruckRoute>> &truck_routes,
+            const std::vector<std::vector<DroneRoute>> &drone_routes,
+            const std::shared_ptr<ParentInfo<Solution>> parent,
+            const bool debug_check = true)
+            : Solution(truck_routes, drone_routes, _calculate_truck_time_segments(truck_routes), parent, debug_check) {}
+
+        Solution(const Solution &) = default;
+
+        /**
+         * @brief Hand the member vectors over to thread-local free lists, so that the next solutions
+         * reuse their storage (including the customers of each route).
+         */
+        ~Solution()
+        {
+            utils::RecycleBin<std::vector<double>>::release(std::move(_truck_working_time));
+            utils::RecycleBin<std::vector<double>>::release(std::move(_drone_working_time));
+            utils::RecycleBin<std::vector<std::vector<TruckRoute>>>::release(std::move(_truck_routes));
+            utils::RecycleBin<std::vector<std::vector<DroneRoute>>>::release(std::move(_drone_routes));
+        }
+
+        /**
+         * @brief Construct a new solution in a `std::shared_ptr`, with the object and its control
+         * block recycled from a thread-local pool of discarded solutions, and its member vectors
+         * from the storage of discarded solutions (see `~Solution`).
+         */
+        template <typename... Args>
+        static std::shared_ptr<Solution> create(Args &&...args)
+        {
+            return std::allocate_shared<Solution>(utils::PoolAllocator<Solution>(), std::forward<Args>(args)...);
+        }
+
+        /** @brief Working time of truck routes */
+        const std::vector<double> &truck_working_time() const
+        {
+            return _truck_working_time;
+        }
+
+        /** @brief Working time of drone routes */
+        const std::vector<double> &drone_working_time() const
+        {
+            return _drone_working_time;
+        }
+
+        /** @brief Routes of trucks */
+        const std::vector<std::vector<TruckRoute>> &truck_routes() const
+        {
+            return _truck_routes;
+        }
+
+        /** @brief Routes of drones */
+        const std::vector<std::vector<DroneRoute>> &drone_routes() const
+        {
+            return _drone_routes;
+        }
+
         /** @brief The parent solution propagating this solution in the result tree */
         std::shared_ptr<ParentInfo<Solution>> parent() const
         {
@@ -211,17 +308,18 @@ namespace d2d
         std::shared_ptr<Solution> destroy_and_repair() const
         {
             const auto problem = Problem::get_instance();
+            utils::InstrumentZone _zone(utils::Instrumentation::PHASES, "phase", "destroy and repair");
 
-            std::vector<std::vector<TruckRoute>> new_truck_routes(truck_routes);
-            std::vector<std::vector<DroneRoute>> new_drone_routes(drone_routes);
+            std::vector<std::vector<TruckRoute>> new_truck_routes(_truck_routes);
+            std::vector<std::vector<DroneRoute>> new_drone_routes(_drone_routes);
 
             // Destroy phase
             std::set<std::size_t> move; // Set of destroyed customers
 
             auto destroy_count = problem->customers.size() * problem->destroy_rate / 100;
+            std::optional<utils::InstrumentZone> _step_zone(std::in_place, utils::Instrumentation::DETAILS, "destroy and repair", "destroy");
             while (move.size() < destroy_count)
             {
-                // std::cerr << "move = " << move << std::endl;
                 std::vector<std::size_t> scores(problem->customers.size());
                 const auto _calculate_scores = [this, &scores]<typename RT, std::enable_if_t<is_route_v<RT>, bool> = true>(const std::vector<std::vector<RT>> &vehicle_routes)
                 {
@@ -233,7 +331,6 @@ namespace d2d
                             for (std::size_t i = 1; i + 1 < customers.size(); i++)
                             {
                                 scores[customers[i]] = best_with_edges[customers[i - 1]][customers[i]] + best_with_edges[customers[i]][customers[i + 1]];
-                                // std::cerr << "scores[" << customers[i] << "] = " << best_with_edges[customers[i - 1]][customers[i]] << " + " << best_with_edges[customers[i]][customers[i + 1]] << " = " << scores[customers[i]] << std::endl;
                             }
                         }
                     }
@@ -241,7 +338,6 @@ namespace d2d
 
                 _calculate_scores(new_truck_routes);
                 _calculate_scores(new_drone_routes);
-                // std::cerr << "scores = " << scores << std::endl;
 
                 std::vector<std::size_t> customers;
                 for (std::size_t i = 1; i < problem->customers.size(); i++)
@@ -264,8 +360,6 @@ namespace d2d
                 const auto customer = customers[index];
                 move.insert(customer);
 
-                // std::cerr << "customers = " << customers << ", index = " << index << ", customer = " << customer << std::endl;
-
                 const auto _destroy = [&customer]<typename RT, std::enable_if_t<is_route_v<RT>, bool> = true>(std::vector<std::vector<RT>> &vehicle_routes)
                 {
                     for (std::size_t vehicle = 0; vehicle < vehicle_routes.size(); vehicle++)
@@ -300,10 +394,13 @@ namespace d2d
             }
 
             // Repair phase
+            _step_zone.reset();
+            _step_zone.emplace(utils::Instrumentation::DETAILS, "destroy and repair", "repair");
+
             std::vector<std::size_t> move_customers(move.begin(), move.end());
             std::shuffle(move_customers.begin(), move_customers.end(), utils::rng);
 
-            const auto parent = std::make_shared<ParentInfo<Solution>>(std::make_shared<Solution>(*this), "destroy & repair");
+            const auto parent = std::make_shared<ParentInfo<Solution>>(Solution::create(*this), "destroy & repair");
             for (const auto &customer : move_customers)
             {
                 double best_working_time = std::numeric_limits<double>::max();
@@ -326,7 +423,7 @@ namespace d2d
                                 // Temporary modify
                                 route = RT(new_customers);
 
-                                auto new_solution = std::make_shared<Solution>(new_truck_routes, new_drone_routes, parent, false);
+                                auto new_solution = Solution::create(new_truck_routes, new_drone_routes, parent, false);
                                 if (new_solution->feasible && new_solution->working_time < best_working_time)
                                 {
                                     best_working_time = new_solution->working_time;
@@ -342,7 +439,7 @@ namespace d2d
                 };
 
                 _try_insert(new_truck_routes);
-                if (problem->customers[customer].dronable)
+                if (problem->columns.dronable[customer])
                 {
                     _try_insert(new_drone_routes);
                 }
@@ -356,7 +453,7 @@ namespace d2d
                         {
                             routes.emplace_back(std::vector<std::size_t>{0, customer, 0});
 
-                            auto new_solution = std::make_shared<Solution>(new_truck_routes, new_drone_routes, parent, false);
+                            auto new_solution = Solution::create(new_truck_routes, new_drone_routes, parent, false);
                             if (new_solution->feasible && new_solution->working_time < best_working_time)
                             {
                                 best_working_time = new_solution->working_time;
@@ -370,16 +467,13 @@ namespace d2d
                     };
 
                     _try_append(new_truck_routes);
-                    if (problem->customers[customer].dronable)
+                    if (problem->columns.dronable[customer])
                     {
                         _try_append(new_drone_routes);
                     }
 
                     if (best_working_time == std::numeric_limits<double>::max())
                     {
-                        // std::cerr << new_truck_routes << std::endl;
-                        // std::cerr << new_drone_routes << std::endl;
-
                         // This should never happen. Appending a new route to a feasible solution should always yield another feasible one.
                         throw std::runtime_error("Unreachable code was reached");
                     }
@@ -396,14 +490,16 @@ namespace d2d
                 }
             }
 
-            // std::cerr << "Destroy & repair from:\n";
-            // std::cerr << truck_routes << " " << drone_routes << std::endl;
-            // std::cerr << "Destroy & repair to:\n";
-            // std::cerr << new_truck_routes << " " << new_drone_routes << std::endl;
+            _step_zone.reset();
+
+            auto result = Solution::create(new_truck_routes, new_drone_routes, _parent);
+            if (utils::Instrumentation::enabled(utils::Instrumentation::DETAILS)) [[unlikely]]
+            {
+                utils::Instrumentation::counter(
+                    "destroy and repair",
+                    {{"destroyed", move.size()}, {"hamming distance", hamming_distance(result)}, {"cost before", cost().value}, {"cost after", result->cost().value}});
+            }
 
-            auto result = std::make_shared<Solution>(new_truck_routes, new_drone_routes, _parent);
-            // std::cerr << "Hamming distance = \e[31m" << hamming_distance(result) << "\e[0m" << std::endl;
-            // std::cerr << "Cost = " << cost() << " -> " << result->cost() << std::endl;
             return result;
         }
 
@@ -419,15 +515,62 @@ namespace d2d
             return result;
         }
 
+        /**
+         * @brief The vehicles (trucks first, then drones) that a move must modify to decrease the cost:
+         * those whose working time is within `epsilon * working_time` of the makespan, and those
+         * whose routes violate a constraint.
+         *
+         * Waiting time violations of trucks are not stored per route, so all trucks are included
+         * when the trucks violate waiting time limits.
+         */
+        std::vector<bool> critical_vehicles(const double &epsilon) const
+        {
+            const auto trucks_count = _truck_routes.size();
+            const auto threshold = (1 - epsilon) * working_time;
+
+            std::vector<bool> result(trucks_count + _drone_routes.size());
+            double drone_waiting_time_violation = 0;
+            for (std::size_t i = 0; i < _drone_routes.size(); i++)
+            {
+                result[trucks_count + i] = _drone_working_time[i] >= threshold;
+                for (auto &route : _drone_routes[i])
+                {
+                    const auto &violations = route.waiting_time_violations();
+                    const auto waiting = std::accumulate(violations.begin(), violations.end(), 0.0);
+                    drone_waiting_time_violation += waiting;
+
+                    if (!utils::approximate(route.capacity_violation() + route.energy_violation() + route.fixed_time_violation() + waiting, 0.0))
+                    {
+                        result[trucks_count + i] = true;
+                    }
+                }
+            }
+
+            const bool truck_waiting = !utils::approximate(waiting_time_violation, drone_waiting_time_violation);
+            for (std::size_t i = 0; i < trucks_count; i++)
+            {
+                result[i] = truck_waiting || _truck_working_time[i] >= threshold;
+                for (auto &route : _truck_routes[i])
+                {
+                    if (!utils::approximate(route.capacity_violation(), 0.0))
+                    {
+                        result[i] = true;
+                    }
+                }
+            }
+
+            return result;
+        }
+
         double hamming_distance(const std::shared_ptr<Solution> other) const
         {
             std::vector<std::size_t> self_repr;
-            _hamming_distance(truck_routes, self_repr);
-            _hamming_distance(drone_routes, self_repr);
+            _hamming_distance(_truck_routes, self_repr);
+            _hamming_distance(_drone_routes, self_repr);
 
             std::vector<std::size_t> other_repr;
-            _hamming_distance(other->truck_routes, other_repr);
-            _hamming_distance(other->drone_routes, other_repr);
+            _hamming_distance(other->truck_routes(), other_repr);
+            _hamming_distance(other->drone_routes(), other_repr);
 
             std::size_t result = 0;
             for (std::size_t i = 0; i < self_repr.size(); i++)
@@ -444,6 +587,7 @@ namespace d2d
         std::shared_ptr<Solution> post_optimization(Logger<Solution> &logger)
         {
             auto problem = Problem::get_instance();
+            utils::InstrumentZone _zone(utils::Instrumentation::PHASES, "phase", "post-optimization");
             std::size_t iteration = 0;
 
             std::vector<std::shared_ptr<BaseNeighborhood<Solution>>> inter_route, intra_route;
@@ -456,28 +600,42 @@ namespace d2d
             inter_route.push_back(std::make_shared<CrossExchange<Solution>>());
             inter_route.push_back(std::make_shared<EjectionChain<Solution>>());
 
-            auto result = std::make_shared<Solution>(*this);
+            auto result = Solution::create(*this);
             bool improved = true;
-            auto aspiration_criteria = [&result, &improved](std::shared_ptr<Solution> s)
+            // The candidates returned by the scans are not used, the aspiration criteria record every
+            // feasible improvement and only hold for these (see `Pruning`)
+            auto aspiration_criteria = [&result, &improved](const std::shared_ptr<Solution> &s)
             {
                 if (s->feasible && s->cost() < result->cost())
                 {
                     result = s;
                     improved = true;
+                    return true;
                 }
 
-                return true; // Accept all solutions in post-optimization
+                return false;
             };
 
+            ScanPolicy inter_route_policy, intra_route_policy;
+            inter_route_policy.scope = ScanPolicy::INTER_ROUTE;
+            intra_route_policy.scope = ScanPolicy::INTRA_ROUTE;
+
             while (improved)
             {
                 improved = false;
                 std::shuffle(inter_route.begin(), inter_route.end(), utils::rng);
                 for (auto &neighborhood : inter_route)
                 {
+                    if (problem->stopped())
+                    {
+                        improved = false;
+                        break;
+                    }
+
+                    iteration++;
                     if (problem->verbose)
                     {
-                        std::cerr << utils::format("\rPost-optimize #%lu(%.2lf)", ++iteration, result->cost()) << std::flush;
+                        std::cerr << utils::format("\rPost-optimize #%lu(%.2lf)", iteration, result->cost()) << std::flush;
                     }
 
                     auto ptr = std::dynamic_pointer_cast<Neighborhood<Solution, true>>(neighborhood);
@@ -486,7 +644,21 @@ namespace d2d
                         ptr->clear();
                     }
 
-                    neighborhood->inter_route(result, aspiration_criteria);
+                    {
+                        utils::InstrumentZone _neighborhood_zone(utils::Instrumentation::NEIGHBORHOODS, "neighborhood", [&neighborhood]
+                                                                 { return neighborhood->label() + "/post-optimization/inter-route"; });
+                        neighborhood->set_pruning({true, result->cost().value});
+                        neighborhood->move(result, aspiration_criteria, inter_route_policy);
+                    }
+
+                    logger.trace(
+                        iteration,
+                        "post-optimization/inter-route",
+                        result,
+                        result,
+                        {},
+                        neighborhood->label(),
+                        ptr == nullptr ? std::vector<std::size_t>() : ptr->last_tabu());
 
 #ifdef LOGGING
                     logger.log(
@@ -507,9 +679,16 @@ namespace d2d
                 std::shuffle(intra_route.begin(), intra_route.end(), utils::rng);
                 for (auto &neighborhood : intra_route)
                 {
+                    if (problem->stopped())
+                    {
+                        improved = false;
+                        break;
+                    }
+
+                    iteration++;
                     if (problem->verbose)
                     {
-                        std::cerr << utils::format("\rPost-optimize #%lu(%.2lf)", ++iteration, result->cost()) << std::flush;
+                        std::cerr << utils::format("\rPost-optimize #%lu(%.2lf)", iteration, result->cost()) << std::flush;
                     }
 
                     auto ptr = std::dynamic_pointer_cast<Neighborhood<Solution, true>>(neighborhood);
@@ -518,7 +697,21 @@ namespace d2d
                         ptr->clear();
                     }
 
-                    neighborhood->intra_route(result, aspiration_criteria);
+                    {
+                        utils::InstrumentZone _neighborhood_zone(utils::Instrumentation::NEIGHBORHOODS, "neighborhood", [&neighborhood]
+                                                                 { return neighborhood->label() + "/post-optimization/intra-route"; });
+                        neighborhood->set_pruning({true, result->cost().value});
+                        neighborhood->move(result, aspiration_criteria, intra_route_policy);
+                    }
+
+                    logger.trace(
+                        iteration,
+                        "post-optimization/intra-route",
+                        result,
+                        result,
+                        {},
+                        neighborhood->label(),
+                        ptr == nullptr ? std::vector<std::size_t>() : ptr->last_tabu());
 
 #ifdef LOGGING
                     logger.log(
@@ -532,57 +725,155 @@ namespace d2d
                 }
             }
 
-            std::vector<std::vector<TruckRoute>> new_truck_routes(result->truck_routes);
-            std::vector<std::vector<DroneRoute>> new_drone_routes(result->drone_routes);
+            // `inter_route` contains every neighborhood used by both the tabu search and the post-optimization
+            for (auto &neighborhood : inter_route)
+            {
+                logger.add_statistics(neighborhood->label(), neighborhood->statistics());
+            }
+
+            // TSP optimization only accepts improvements, so it is skipped when out of time or interrupted
+            if (problem->stopped())
+            {
+                if (problem->verbose)
+                {
+                    std::cerr << std::endl;
+                }
+
+                return result;
+            }
+
+            std::vector<std::vector<TruckRoute>> new_truck_routes(result->truck_routes());
+            std::vector<std::vector<DroneRoute>> new_drone_routes(result->drone_routes());
 
             auto parent = std::make_shared<ParentInfo<Solution>>(result, "TSP optimization");
-            auto optimize_route = [&problem, &result, &new_truck_routes, &new_drone_routes, &parent]<typename RT, std::enable_if_t<is_route_v<RT>, bool> = true>(std::vector<std::vector<RT>> &vehicle_routes)
+
             {
-                for (auto &routes : vehicle_routes)
+                utils::InstrumentZone _tsp_zone(utils::Instrumentation::PHASES, "phase", "TSP optimization");
+
+                // The reordered routes do not depend on each other, so they are computed concurrently. A
+                // Held-Karp table grows as 2^n, so the routes with large tables are reordered one at a time
+                // on this thread while the pool handles the others: peak memory does not grow with the
+                // number of hardware threads.
+                std::vector<std::vector<TruckRoute>> truck_candidates(new_truck_routes);
+                std::vector<std::vector<DroneRoute>> drone_candidates(new_drone_routes);
                 {
-                    for (auto &route : routes)
+                    utils::ThreadPool pool;
+                    std::vector<std::future<void>> futures;
+                    const auto schedule = [&pool, &futures]<typename RT, std::enable_if_t<is_route_v<RT>, bool> = true>(
+                                              std::vector<std::vector<RT>> &vehicle_routes,
+                                              const bool &concurrent)
                     {
-                        RT old_route(route);
+                        for (auto &routes : vehicle_routes)
+                        {
+                            for (auto &route : routes)
+                            {
+                                if (_tsp_concurrent(route) != concurrent)
+                                {
+                                    continue;
+                                }
+
+                                const auto task = [&route]()
+                                {
+                                    utils::InstrumentZone _task_zone(
+                                        utils::Instrumentation::DETAILS,
+                                        "tsp",
+                                        std::is_same_v<RT, TruckRoute> ? "truck" : "drone");
+                                    route = _tsp_optimize(route);
+                                };
+
+                                if (concurrent)
+                                {
+                                    futures.push_back(pool.submit(task));
+                                }
+                                else
+                                {
+                                    task();
+                                }
+                            }
+                        }
+                    };
 
-                        std::vector<std::size_t> customers(route.customers());
-                        customers.pop_back();
+                    schedule(truck_candidates, true);
+                    schedule(drone_candidates, true);
+                    schedule(truck_candidates, false);
+                    schedule(drone_candidates, false);
 
-                        auto distance = [&problem, &customers](const std::size_t &i, const std::size_t &j)
+                    for (auto &future : futures)
+                    {
+                        future.get();
+                    }
+                }
+
+                // A reordered route is kept if the whole solution stays feasible and its cost drops below
+                // the cost of `result`, in the order of the vehicles and routes. The solution is evaluated
+                // from the working times and violations of its vehicles, only the modified one is updated.
+                const auto trucks_count = new_truck_routes.size();
+                std::vector<VehicleEvaluation> evaluations;
+                for (auto &routes : new_truck_routes)
+                {
+                    evaluations.push_back(evaluate_vehicle(routes));
+                }
+                for (auto &routes : new_drone_routes)
+                {
+                    evaluations.push_back(evaluate_vehicle(routes));
+                }
+
+                const auto accept = [&result, &evaluations]()
+                {
+                    double working_time = 0, energy_violation = 0, capacity_violation = 0, waiting_time_violation = 0, fixed_time_violation = 0;
+                    for (auto &evaluation : evaluations)
+                    {
+                        working_time = std::max(working_time, evaluation.working_time);
+                        energy_violation += evaluation.energy_violation;
+                        capacity_violation += evaluation.capacity_violation;
+                        waiting_time_violation += evaluation.waiting_time_violation;
+                        fixed_time_violation += evaluation.fixed_time_violation;
+                    }
+
+                    const bool feasible = utils::approximate(energy_violation, 0.0) &&
+                                          utils::approximate(capacity_violation, 0.0) &&
+                                          utils::approximate(waiting_time_violation, 0.0) &&
+                                          utils::approximate(fixed_time_violation, 0.0);
+                    const auto cost = working_time + A1 * energy_violation + A2 * capacity_violation + A3 * waiting_time_violation + A4 * fixed_time_violation;
+                    return feasible && utils::FloatingPointWrapper<double>(cost) < result->cost();
+                };
+
+                const auto select = [&evaluations, &accept]<typename RT, std::enable_if_t<is_route_v<RT>, bool> = true>(
+                                        std::vector<RT> &routes,
+                                        const std::vector<RT> &candidates,
+                                        const std::size_t &vehicle)
+                {
+                    for (std::size_t i = 0; i < routes.size(); i++)
+                    {
+                        if (candidates[i].customers() == routes[i].customers())
                         {
-                            return problem->distances[customers[i]][customers[j]];
-                        };
-
-                        std::vector<std::size_t> ordered(customers.size());
-                        std::iota(ordered.begin(), ordered.end(), 0);
-                        ordered = customers.size() < 23 ? utils::held_karp_algorithm(customers.size(), distance).second
-                                                        : utils::two_opt_heuristic(customers.size(), distance, ordered).second;
-
-                        std::vector<std::size_t> new_customers(customers.size());
-                        std::transform(
-                            ordered.begin(), ordered.end(), new_customers.begin(),
-                            [&customers](const std::size_t &i)
-                            { return customers[i]; });
-
-                        std::rotate(
-                            new_customers.begin(),
-                            std::find(new_customers.begin(), new_customers.end(), 0),
-                            new_customers.end());
-
-                        new_customers.push_back(0);
-                        route = RT(new_customers);
-
-                        auto new_solution = std::make_shared<Solution>(new_truck_routes, new_drone_routes, parent);
-                        if (!new_solution->feasible || new_solution->cost() >= result->cost())
+                            continue;
+                        }
+
+                        RT old_route(routes[i]);
+                        const auto old_evaluation = evaluations[vehicle];
+
+                        routes[i] = candidates[i];
+                        evaluations[vehicle] = evaluate_vehicle(routes);
+                        if (!accept())
                         {
-                            route = old_route;
+                            routes[i] = old_route;
+                            evaluations[vehicle] = old_evaluation;
                         }
                     }
+                };
+
+                for (std::size_t i = 0; i < trucks_count; i++)
+                {
+                    select(new_truck_routes[i], truck_candidates[i], i);
                 }
-            };
+                for (std::size_t i = 0; i < new_drone_routes.size(); i++)
+                {
+                    select(new_drone_routes[i], drone_candidates[i], trucks_count + i);
+                }
+            }
 
-            optimize_route(new_truck_routes);
-            optimize_route(new_drone_routes);
-            result = std::make_shared<Solution>(new_truck_routes, new_drone_routes, parent);
+            result = Solution::create(new_truck_routes, new_drone_routes, parent);
 
             if (problem->verbose)
             {
@@ -594,7 +885,7 @@ namespace d2d
 
         bool operator==(const Solution &other) const
         {
-            return truck_routes == other.truck_routes && drone_routes == other.drone_routes;
+            return _truck_routes == other._truck_routes && _drone_routes == other._drone_routes;
         }
 
         bool operator!=(const Solution &other) const
@@ -603,8 +894,13 @@ namespace d2d
         }
 
         static std::shared_ptr<Solution> tabu_search(Logger<Solution> &logger);
+
+    private:
+        static utils::InstrumentCounter _solutions_counter;
     };
 
+    utils::InstrumentCounter Solution::_solutions_counter("solutions", utils::Instrumentation::DETAILS);
+
     double Solution::A1 = 1;
     double Solution::A2 = 1;
     double Solution::A3 = 1;
@@ -620,22 +916,28 @@ namespace d2d
         std::make_shared<TwoOpt<Solution>>(),
     };
 
-    std::vector<std::vector<std::vector<double>>> Solution::_calculate_truck_time_segments(
+    /**
+     * @brief Calculate the time segments of all truck routes into a thread-local buffer, whose
+     * storage is reused by the next solution constructed on the same thread.
+     */
+    const std::vector<std::vector<std::vector<double>>> &Solution::_calculate_truck_time_segments(
         const std::vector<std::vector<TruckRoute>> &truck_routes)
     {
-        std::vector<std::vector<std::vector<double>>> result(truck_routes.size());
+        thread_local std::vector<std::vector<std::vector<double>>> result;
+        result.resize(truck_routes.size());
         for (std::size_t i = 0; i < truck_routes.size(); i++)
         {
-            result[i].reserve(truck_routes[i].size());
+            result[i].resize(truck_routes[i].size());
 
             std::size_t coefficients_index = 0;
             double current_within_timespan = 0;
             for (std::size_t j = 0; j < truck_routes[i].size(); j++)
             {
-                result[i].push_back(TruckRoute::calculate_time_segments(
+                TruckRoute::calculate_time_segments(
                     truck_routes[i][j].customers(),
                     coefficients_index,
-                    current_within_timespan));
+                    current_within_timespan,
+                    result[i][j]);
             }
         }
 
@@ -644,7 +946,8 @@ namespace d2d
 
     std::vector<double> Solution::_calculate_truck_working_time(const std::vector<std::vector<std::vector<double>>> &truck_time_segments)
     {
-        std::vector<double> result;
+        auto result = utils::RecycleBin<std::vector<double>>::acquire();
+        result.clear();
         result.reserve(truck_time_segments.size());
 
         for (auto &routes : truck_time_segments)
@@ -662,7 +965,8 @@ namespace d2d
 
     std::vector<double> Solution::_calculate_drone_working_time(const std::vector<std::vector<DroneRoute>> &drone_routes)
     {
-        std::vector<double> result;
+        auto result = utils::RecycleBin<std::vector<double>>::acquire();
+        result.clear();
         result.reserve(drone_routes.size());
 
         for (auto &routes : drone_routes)
@@ -783,6 +1087,91 @@ namespace d2d
         return result;
     }
 
+    /**
+     * @brief The working time and constraint violations of a single truck, summed in the same order
+     * as the totals of a solution.
+     */
+    VehicleEvaluation Solution::evaluate_vehicle(const std::vector<TruckRoute> &routes)
+    {
+        VehicleEvaluation result;
+
+        std::size_t coefficients_index = 0;
+        double current_within_timespan = 0;
+        std::vector<double> time_segments;
+        for (auto &route : routes)
+        {
+            TruckRoute::calculate_time_segments(route.customers(), coefficients_index, current_within_timespan, time_segments);
+            auto waiting_time_violations = TruckRoute::calculate_waiting_time_violations(route.customers(), time_segments);
+
+            result.working_time += std::accumulate(time_segments.begin(), time_segments.end(), 0.0);
+            result.capacity_violation += route.capacity_violation();
+            result.waiting_time_violation += std::accumulate(waiting_time_violations.begin(), waiting_time_violations.end(), 0.0);
+        }
+
+        return result;
+    }
+
+    /** @brief The working time and constraint violations of a single drone. */
+    VehicleEvaluation Solution::evaluate_vehicle(const std::vector<DroneRoute> &routes)
+    {
+        auto problem = Problem::get_instance();
+        VehicleEvaluation result;
+        for (auto &route : routes)
+        {
+            const auto &waiting_time_violations = route.waiting_time_violations();
+
+            result.working_time += route.working_time();
+            result.capacity_violation += route.capacity_violation();
+            result.waiting_time_violation += std::accumulate(waiting_time_violations.begin(), waiting_time_violations.end(), 0.0);
+            if (problem->endurance == nullptr)
+            {
+                result.energy_violation += route.energy_violation();
+            }
+            else
+            {
+                result.fixed_time_violation += route.fixed_time_violation();
+            }
+        }
+
+        return result;
+    }
+
+    /** @brief Reorder the customers of a route by solving the TSP over them (starting from the depot). */
+    template <typename RT, std::enable_if_t<is_route_v<RT>, bool>>
+    RT Solution::_tsp_optimize(const RT &route)
+    {
+        auto problem = Problem::get_instance();
+
+        std::vector<std::size_t> customers(route.customers());
+        customers.pop_back();
+
+        const auto &distances = std::is_same_v<RT, TruckRoute> ? problem->truck_distances : problem->distances;
+        const double scale = std::is_same_v<RT, TruckRoute> ? problem->truck_distance_scale : 1.0;
+        auto distance = [&distances, &scale, &customers](const std::size_t &i, const std::size_t &j)
+        {
+            return distances[customers[i]][customers[j]] * scale;
+        };
+
+        std::vector<std::size_t> ordered(customers.size());
+        std::iota(ordered.begin(), ordered.end(), 0);
+        ordered = customers.size() < _HELD_KARP_LIMIT ? utils::held_karp_algorithm(customers.size(), distance).second
+                                                      : utils::two_opt_heuristic(customers.size(), distance, ordered).second;
+
+        std::vector<std::size_t> new_customers(customers.size());
+        std::transform(
+            ordered.begin(), ordered.end(), new_customers.begin(),
+            [&customers](const std::size_t &i)
+            { return customers[i]; });
+
+        std::rotate(
+            new_customers.begin(),
+            std::find(new_customers.begin(), new_customers.end(), 0),
+            new_customers.end());
+
+        new_customers.push_back(0);
+        return RT(new_customers);
+    }
+
     std::array<double, 4> Solution::penalty_coefficients()
     {
         return {A1, A2, A3, A4};
@@ -793,7 +1182,13 @@ namespace d2d
     std::shared_ptr<Solution> Solution::tabu_search(Logger<Solution> &logger)
     {
         auto problem = Problem::get_instance();
-        auto initial_1 = initial_impl<d2d::Solution, 1>(), initial_2 = initial_impl<d2d::Solution, 2>();
+
+        std::shared_ptr<Solution> initial_1, initial_2;
+        {
+            utils::InstrumentZone _zone(utils::Instrumentation::PHASES, "phase", "initialization");
+            initial_1 = initial_impl<d2d::Solution, 1>();
+            initial_2 = initial_impl<d2d::Solution, 2>();
+        }
 
         std::vector<std::shared_ptr<Solution>> elite;
         if (initial_1->feasible)
@@ -809,11 +1204,11 @@ namespace d2d
 
         std::size_t base_hyperparameter = (problem->customers.size() - 1) /
                                           (std::accumulate(
-                                               current->truck_routes.begin(), current->truck_routes.end(), 0,
+                                               current->truck_routes().begin(), current->truck_routes().end(), 0,
                                                [](const std::size_t &s, const std::vector<TruckRoute> &routes)
                                                { return s + !routes.empty(); }) +
                                            std::accumulate(
-                                               current->drone_routes.begin(), current->drone_routes.end(), 0,
+                                               current->drone_routes().begin(), current->drone_routes().end(), 0,
                                                [](const std::size_t &s, const std::vector<DroneRoute> &routes)
                                                { return s + !routes.empty(); }));
 
@@ -824,13 +1219,80 @@ namespace d2d
         std::cerr << "verbose = " << problem->verbose << "\n";
         std::cerr << "trucks_count = " << problem->trucks_count << ", drones_count = " << problem->drones_count << "\n";
         std::cerr << "strategy = " << problem->strategy << "\n";
+
+        // A full scan grows with the square of the number of customers (or faster), so large instances
+        // stop at the first improvement or evaluate a sample of the candidates
+        std::string scan_mode = problem->scan_policy;
+        if (scan_mode == "auto")
+        {
+            const auto customers_count = problem->customers.size() - 1;
+            scan_mode = customers_count <= 200 ? "best" : (customers_count <= 500 ? "first" : "sampled");
+        }
+
+        ScanPolicy scan_policy;
+        if (scan_mode == "first")
+        {
+            scan_policy.mode = ScanPolicy::FIRST;
+        }
+        else if (scan_mode == "sampled")
+        {
+            scan_policy.mode = ScanPolicy::SAMPLED;
+            scan_policy.sample_rate = problem->sample_rate;
+        }
+        else if (scan_mode != "best")
+        {
+            throw std::invalid_argument(utils::format("Unrecognized scan policy \"%s\"", scan_mode.c_str()));
+        }
+
+        std::cerr << "scan_policy = " << scan_mode << "\n";
+        if (problem->critical_focus >= 0)
+        {
+            std::cerr << "critical_focus = " << problem->critical_focus << ", critical_period = " << problem->critical_period << "\n";
+        }
+
         std::cerr << "waiting_time_limit = " << problem->waiting_time_limit << "\n";
         std::cerr << "max_elite_size = " << problem->max_elite_size << ", reset_after = " << problem->reset_after << "\n";
 
+        // The search stops once the relative gap (wt - lb) / wt of the best feasible solution is at most `gap_limit`
+        double lower_bound = 0;
+        if (problem->gap_limit >= 0)
+        {
+            utils::InstrumentZone _zone(utils::Instrumentation::PHASES, "phase", "lower bound");
+            LowerBound bound;
+            lower_bound = logger.lower_bound = bound.value();
+            std::cerr << "lower_bound = " << lower_bound << " (round trip " << bound.round_trip << ", relaxation " << bound.relaxation << ", exact " << bound.exact << ", energy " << bound.energy << ")\n";
+        }
+
+        // Resets stop helping once the best cost no longer improves and the elite set has converged
+        utils::StagnationMonitor stagnation(problem->reset_after);
+        if (problem->stagnation_gain >= 0)
+        {
+            std::cerr << "stagnation_gain = " << problem->stagnation_gain << ", stagnation_spread = " << problem->stagnation_spread << "\n";
+        }
+
+        // Mean Hamming distance between elite solutions, relative to the number of customers
+        const auto elite_spread = [&problem, &elite]()
+        {
+            double total = 0;
+            std::size_t pairs = 0;
+            for (std::size_t i = 0; i < elite.size(); i++)
+            {
+                for (std::size_t j = i + 1; j < elite.size(); j++)
+                {
+                    total += elite[i]->hamming_distance(elite[j]);
+                    pairs++;
+                }
+            }
+
+            return pairs == 0 ? 0.0 : total / pairs / (problem->customers.size() - 1);
+        };
+
         logger.last_improved = 0;
         logger.iterations = 0;
+        logger.improve(0, result);
 
         std::size_t neighborhood = 0;
+        utils::AdaptiveRoulette roulette(_neighborhoods.size());
         auto insert_elite = [&problem, &elite, &result]()
         {
             if (problem->max_elite_size == 0)
@@ -853,9 +1315,22 @@ namespace d2d
             elite.push_back(result);
         };
 
+        std::optional<utils::InstrumentZone> _search_zone;
+        _search_zone.emplace(utils::Instrumentation::PHASES, "phase", "tabu search");
+
         std::size_t iteration_cap = (problem->fix_iteration > 0 ? problem->fix_iteration : std::numeric_limits<int>::max());
         for (std::size_t iteration = 0; iteration < iteration_cap; iteration++)
         {
+            if (problem->search_stopped())
+            {
+                break;
+            }
+
+            if (problem->gap_limit >= 0 && result->feasible && result->working_time - lower_bound <= problem->gap_limit * result->working_time + TOLERANCE)
+            {
+                break;
+            }
+
             if (problem->verbose)
             {
                 std::string format_string = utils::format(
@@ -884,12 +1359,13 @@ namespace d2d
 
             logger.iterations = iteration + 1;
 
-            const auto aspiration_criteria = [&logger, &result, &insert_elite, &iteration](std::shared_ptr<Solution> ptr)
+            const auto aspiration_criteria = [&logger, &result, &insert_elite, &iteration](const std::shared_ptr<Solution> &ptr)
             {
                 if (ptr->feasible && ptr->cost() < result->cost() && (!result->feasible || ptr->working_time < result->working_time))
                 {
                     result = ptr;
                     logger.last_improved = iteration;
+                    logger.improve(iteration + 1, result);
                     insert_elite();
                     return true;
                 }
@@ -897,8 +1373,28 @@ namespace d2d
                 return false;
             };
 
-            auto neighbor = _neighborhoods[neighborhood]->move(current, aspiration_criteria); // result is updated by aspiration_criteria
+            const auto best_cost = result->cost().value;
+            const auto move_start = _neighborhoods[neighborhood]->statistics().elapsed;
+
+            // With a critical focus, inter-route moves must modify a critical vehicle, except in the full
+            // scans every `critical_period` iterations
+            if (problem->critical_focus >= 0)
+            {
+                scan_policy.focus.clear();
+                if (iteration % std::max<std::size_t>(problem->critical_period, 1) != 0)
+                {
+                    scan_policy.focus = current->critical_vehicles(problem->critical_focus);
+                }
+            }
+
+            _neighborhoods[neighborhood]->set_pruning({true, result->cost().value});
+            auto neighbor = _neighborhoods[neighborhood]->move(current, aspiration_criteria, scan_policy); // result is updated by aspiration_criteria
             auto old_current = current;
+
+            // Reward of the "adaptive" strategy: the decrease of the current cost, plus the decrease of the best cost
+            const auto move_gain = (neighbor == nullptr ? 0.0 : std::max(0.0, current->cost().value - neighbor->cost().value)) + (best_cost - result->cost().value);
+            const auto move_time = _neighborhoods[neighborhood]->statistics().elapsed - move_start;
+            stagnation.update(best_cost, result->cost().value);
             if (logger.last_improved == iteration)
             {
                 current = result;
@@ -916,6 +1412,29 @@ namespace d2d
                     break;
                 }
 
+                // When stagnating, switch to cheaper first-improvement scans once, then stop
+                if (problem->stagnation_gain >= 0)
+                {
+                    const auto expected_gain = stagnation.expected_gain(problem->reset_after), spread = elite_spread();
+                    if (expected_gain < problem->stagnation_gain && spread <= problem->stagnation_spread)
+                    {
+                        const bool stop = scan_policy.mode != ScanPolicy::BEST;
+                        std::cerr << utils::format(
+                            "Stagnation at iteration %lu (expected gain %lf, elite spread %lf), %s\n",
+                            iteration + 1,
+                            expected_gain,
+                            spread,
+                            stop ? "stopping" : "switching to first-improvement scans");
+
+                        if (stop)
+                        {
+                            break;
+                        }
+
+                        scan_policy.mode = ScanPolicy::FIRST;
+                    }
+                }
+
                 auto iter = utils::random_element(elite);
                 current = (*iter)->destroy_and_repair();
                 elite.erase(iter);
@@ -926,13 +1445,36 @@ namespace d2d
                 }
             }
 
+            if (utils::Instrumentation::enabled(utils::Instrumentation::PHASES)) [[unlikely]]
+            {
+                utils::Instrumentation::counter(
+                    "cost",
+                    {{"result", result->cost().value}, {"current", current->cost().value}});
+                utils::Instrumentation::counter(
+                    "penalty",
+                    {{"A1", A1}, {"A2", A2}, {"A3", A3}, {"A4", A4}});
+                utils::InstrumentCounter::sample();
+            }
+
+            {
+                utils::InstrumentZone _logger_zone(utils::Instrumentation::NEIGHBORHOODS, "logger", "logger");
+                logger.trace(
+                    iteration,
+                    "tabu",
+                    result,
+                    current,
+                    elite,
+                    _neighborhoods[neighborhood]->label(),
+                    _neighborhoods[neighborhood]->last_tabu());
+
 #ifdef LOGGING
-            logger.log(
-                result,
-                current,
-                elite,
-                std::make_pair(_neighborhoods[neighborhood]->label(), _neighborhoods[neighborhood]->last_tabu()));
+                logger.log(
+                    result,
+                    current,
+                    elite,
+                    std::make_pair(_neighborhoods[neighborhood]->label(), _neighborhoods[neighborhood]->last_tabu()));
 #endif
+            }
 
             const auto violation_update = [](double &A, const double &violation)
             {
@@ -980,6 +1522,11 @@ namespace d2d
 
                 last_last_improved = logger.last_improved;
             }
+            else if (problem->strategy == "adaptive")
+            {
+                roulette.update(neighborhood, move_gain, move_time);
+                neighborhood = roulette.select();
+            }
             else
             {
                 throw std::invalid_argument(utils::format("Unrecognized strategy \"%s\"", problem->strategy.c_str()));
@@ -991,7 +1538,10 @@ namespace d2d
             std::cerr << std::endl;
         }
 
+        _search_zone.reset();
+
         auto post_opt = result->post_optimization(logger);
+        logger.improve(logger.iterations, post_opt);
         return post_opt;
     }
 }
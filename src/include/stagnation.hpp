@@ -0,0 +1,53 @@
+#pragma once
+
+#include "standard.hpp"
+
+namespace utils
+{
+    /**
+     * @brief Tracks the improvement rate of a search to detect stagnation.
+     *
+     * The rate is an exponential moving average of the relative improvement of the best cost per
+     * iteration, so that an improvement weighs about 37% of its value after `window` iterations
+     * without another one.
+     */
+    class StagnationMonitor
+    {
+    private:
+        double _rate = 0;
+        const double _decay;
+
+    public:
+        /**
+         * @brief Construct a new StagnationMonitor object
+         *
+         * @param window The number of iterations over which improvements are averaged
+         */
+        explicit StagnationMonitor(const std::size_t &window)
+            : _decay(1.0 - 1.0 / std::max<std::size_t>(window, 1)) {}
+
+        /**
+         * @brief Record an iteration
+         *
+         * @param before The best cost before this iteration
+         * @param after The best cost after this iteration
+         */
+        void update(const double &before, const double &after)
+        {
+            const auto gain = before > 0 ? std::max(0.0, (before - after) / before) : 0.0;
+            _rate = _decay * _rate + (1 - _decay) * gain;
+        }
+
+        /** @brief The average relative improvement per iteration */
+        double rate() const
+        {
+            return _rate;
+        }
+
+        /** @brief The relative improvement expected over the next `iterations` iterations at the current rate */
+        double expected_gain(const std::size_t &iterations) const
+        {
+            return _rate * iterations;
+        }
+    };
+}
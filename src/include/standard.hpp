@@ -2,21 +2,35 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <charconv>
 #include <chrono>
 #include <cmath>
+#include <concepts>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <functional>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <limits>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <queue>
 #include <random>
 #include <set>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
 #include <vector>
 
 #if defined(_WIN32) && !defined(WIN32)
@@ -27,8 +41,11 @@
 #define WIN32_LEAN_AND_MEAN // otherwise "rad1" macro in dlgs.h clashes with "rad1" variable in ALGLIB optimization.h
 #include <windows.h>
 #elif defined(__linux__)
+#include <fcntl.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #endif
 
 #include <cxxabi.h>
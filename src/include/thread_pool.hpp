@@ -0,0 +1,114 @@
+#pragma once
+
+#include "utils.hpp"
+
+namespace utils
+{
+    /**
+     * @brief A fixed-size pool of worker threads consuming tasks from a shared queue.
+     *
+     * All workers are joined on destruction, after the remaining tasks have been consumed.
+     */
+    class ThreadPool
+    {
+    private:
+        std::vector<std::thread> _workers;
+        std::queue<std::function<void()>> _tasks;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        bool _stopped = false;
+
+        void _work()
+        {
+            while (true)
+            {
+                std::function<void()> task;
+
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _condition.wait(lock, [this]
+                                    { return _stopped || !_tasks.empty(); });
+
+                    if (_stopped && _tasks.empty())
+                    {
+                        return;
+                    }
+
+                    task = std::move(_tasks.front());
+                    _tasks.pop();
+                }
+
+                task();
+            }
+        }
+
+    public:
+        /**
+         * @brief Construct a new ThreadPool object.
+         *
+         * @param size The number of worker threads. Pass `0` to use the number of hardware threads.
+         */
+        ThreadPool(const std::size_t &size = 0)
+        {
+            std::size_t count = size == 0 ? std::max(1u, std::thread::hardware_concurrency()) : size;
+            _workers.reserve(count);
+            for (std::size_t i = 0; i < count; i++)
+            {
+                _workers.emplace_back(&ThreadPool::_work, this);
+            }
+        }
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stopped = true;
+            }
+
+            _condition.notify_all();
+            for (auto &worker : _workers)
+            {
+                worker.join();
+            }
+        }
+
+        /** @brief The number of worker threads */
+        std::size_t size() const
+        {
+            return _workers.size();
+        }
+
+        /**
+         * @brief Schedule a callable for execution on a worker thread.
+         *
+         * @param function The callable to execute, taking no arguments
+         * @return A future holding the return value (or the exception) of `function`
+         */
+        template <typename _Function>
+        std::future<std::invoke_result_t<_Function>> submit(_Function &&function)
+        {
+            using _Result = std::invoke_result_t<_Function>;
+
+            // std::function requires a copyable target, hence the shared_ptr
+            auto task = std::make_shared<std::packaged_task<_Result()>>(std::forward<_Function>(function));
+            auto future = task->get_future();
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_stopped)
+                {
+                    throw std::runtime_error("Cannot submit a task to a stopped ThreadPool");
+                }
+
+                _tasks.emplace([task]()
+                               { (*task)(); });
+            }
+
+            _condition.notify_one();
+            return future;
+        }
+    };
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "format.hpp"
+#include "ring_buffer.hpp"
+
+namespace d2d
+{
+    /** @brief Compact summary of one search step, see `TraceWriter` for the output format. */
+    struct TraceRecord
+    {
+        static constexpr std::size_t MAX_LABEL = 48;
+        static constexpr std::size_t MAX_TABU = 8;
+        static constexpr std::size_t MAX_ELITE = 16;
+
+        // Cost, working time, drone energy, capacity, waiting time and fixed time violations
+        using metrics_t = std::array<double, 6>;
+
+        std::size_t iteration;
+        const char *phase; // Must point to a string literal
+        char neighborhood[MAX_LABEL];
+
+        metrics_t result, current;
+        bool result_feasible, current_feasible;
+        std::array<double, 4> coefficients;
+
+        std::size_t tabu_count; // May exceed MAX_TABU, only the first MAX_TABU attributes are kept
+        std::array<std::size_t, MAX_TABU> tabu;
+
+        std::size_t elite_count; // May exceed MAX_ELITE, only the first MAX_ELITE costs are kept
+        std::array<double, MAX_ELITE> elite;
+    };
+
+    /**
+     * @brief Streams `TraceRecord`s to a file from a background thread.
+     *
+     * The search thread only copies fixed-size records into a bounded lock-free ring buffer, so
+     * memory stays constant however long the run is. When the buffer is full the search thread
+     * waits for the writer instead of dropping records.
+     *
+     * The output is tab-separated text with a header line. Tabu attributes and elite costs are
+     * comma-separated lists.
+     */
+    class TraceWriter
+    {
+    private:
+        utils::SPSCRingBuffer<TraceRecord> _buffer;
+        std::ofstream _output;
+        std::atomic<bool> _stopped = false;
+        std::size_t _stalls = 0;
+        std::thread _worker;
+
+        void _write(const TraceRecord &record)
+        {
+            _output << record.iteration << '\t' << record.phase << '\t' << record.neighborhood;
+            for (auto &value : record.result)
+            {
+                _output << '\t' << value;
+            }
+            _output << '\t' << record.result_feasible;
+            for (auto &value : record.current)
+            {
+                _output << '\t' << value;
+            }
+            _output << '\t' << record.current_feasible;
+            for (auto &value : record.coefficients)
+            {
+                _output << '\t' << value;
+            }
+
+            _output << '\t';
+            for (std::size_t i = 0; i < std::min(record.tabu_count, TraceRecord::MAX_TABU); i++)
+            {
+                _output << (i == 0 ? "" : ",") << record.tabu[i];
+            }
+
+            _output << '\t' << record.elite_count << '\t';
+            for (std::size_t i = 0; i < std::min(record.elite_count, TraceRecord::MAX_ELITE); i++)
+            {
+                _output << (i == 0 ? "" : ",") << record.elite[i];
+            }
+
+            _output << '\n';
+        }
+
+        void _work()
+        {
+            TraceRecord record;
+            while (true)
+            {
+                // Read the flag before draining, so that records pushed before destruction are never lost
+                bool stopped = _stopped.load(std::memory_order_acquire);
+                bool consumed = false;
+                while (_buffer.try_pop(record))
+                {
+                    _write(record);
+                    consumed = true;
+                }
+
+                if (stopped)
+                {
+                    break;
+                }
+
+                if (!consumed)
+                {
+                    std::this_thread::sleep_for(std::chrono::microseconds(500));
+                }
+            }
+
+            _output.flush();
+        }
+
+    public:
+        /**
+         * @brief Open the trace file and start the writer thread.
+         *
+         * @param path The output path
+         * @param capacity The number of records the ring buffer can hold
+         */
+        TraceWriter(const std::string &path, const std::size_t &capacity = 4096)
+            : _buffer(capacity), _output(path)
+        {
+            if (!_output)
+            {
+                throw std::runtime_error(utils::format("Unable to open \"%s\" for writing", path.c_str()));
+            }
+
+            _output << std::fixed << std::setprecision(6);
+            _output << "iteration\tphase\tneighborhood";
+            for (auto prefix : {"result", "current"})
+            {
+                for (auto metric : {"cost", "working_time", "drone_energy_violation", "capacity_violation", "waiting_time_violation", "fixed_time_violation", "feasible"})
+                {
+                    _output << '\t' << prefix << '_' << metric;
+                }
+            }
+            _output << "\tA1\tA2\tA3\tA4\ttabu\telite_size\telite\n";
+
+            _worker = std::thread(&TraceWriter::_work, this);
+        }
+
+        TraceWriter(const TraceWriter &) = delete;
+        TraceWriter &operator=(const TraceWriter &) = delete;
+
+        ~TraceWriter()
+        {
+            _stopped.store(true, std::memory_order_release);
+            _worker.join();
+        }
+
+        /** @brief Enqueue a record, called from the search thread only. */
+        void push(const TraceRecord &record)
+        {
+            while (!_buffer.try_push(record))
+            {
+                _stalls++;
+                std::this_thread::yield();
+            }
+        }
+
+        /** @brief The number of times `push` had to wait for the writer thread */
+        std::size_t stalls() const
+        {
+            return _stalls;
+        }
+    };
+}
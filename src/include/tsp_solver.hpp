@@ -5,11 +5,16 @@
 
 namespace utils
 {
+    /** @brief A callable returning the distance between 2 vertices (0-based indices) */
+    template <typename _Distance>
+    using is_distance_t = std::enable_if_t<std::is_invocable_r_v<double, const _Distance &, const std::size_t &, const std::size_t &>, bool>;
+
+    template <typename _Distance, is_distance_t<_Distance> = true>
     std::pair<double, std::size_t> __held_karp_solve(
         const std::size_t &n,
         const std::size_t &bitmask,
         const std::size_t &city,
-        const std::function<double(const std::size_t &, const std::size_t &)> &distance,
+        const _Distance &distance,
         std::vector<std::vector<std::pair<double, std::size_t>>> &dp)
     {
         if (dp[bitmask][city].first != -1.0)
@@ -44,9 +49,10 @@ namespace utils
         return dp[bitmask][city] = result;
     }
 
+    template <typename _Distance, is_distance_t<_Distance> = true>
     std::pair<double, std::vector<std::size_t>> __held_karp(
         const std::size_t &n,
-        const std::function<double(const std::size_t &, const std::size_t &)> &distance)
+        const _Distance &distance)
     {
         // https://en.wikipedia.org/wiki/Held-Karp_algorithm
         std::vector<std::vector<std::pair<double, std::size_t>>> dp(1u << n, std::vector<std::pair<double, std::size_t>>(n, {-1.0, n}));
@@ -81,9 +87,16 @@ namespace utils
         return {distance_end.first, path};
     }
 
+    /** @brief The size in bytes of the dynamic programming table of `held_karp_algorithm` over `n` vertices */
+    constexpr std::size_t held_karp_memory(const std::size_t &n)
+    {
+        return (std::size_t(1) << n) * (sizeof(std::vector<std::pair<double, std::size_t>>) + n * sizeof(std::pair<double, std::size_t>));
+    }
+
+    template <typename _Distance, is_distance_t<_Distance> = true>
     std::pair<double, std::vector<std::size_t>> held_karp_algorithm(
         const std::size_t &n,
-        const std::function<double(const std::size_t &, const std::size_t &)> &distance)
+        const _Distance &distance)
     {
         if (n == 0)
         {
@@ -99,9 +112,10 @@ namespace utils
         return __held_karp(n, distance);
     }
 
+    template <typename _Distance, is_distance_t<_Distance> = true>
     std::pair<double, std::vector<std::size_t>> nearest_heuristic(
         const std::size_t &n,
-        const std::function<double(const std::size_t &, const std::size_t &)> &distance)
+        const _Distance &distance)
     {
         std::vector<std::size_t> path(n);
         std::iota(path.begin(), path.end(), 0);
@@ -130,9 +144,10 @@ namespace utils
         return std::make_pair(d, path);
     }
 
+    template <typename _Distance, is_distance_t<_Distance> = true>
     std::pair<double, std::vector<std::size_t>> two_opt_heuristic(
         const std::size_t &n,
-        const std::function<double(const std::size_t &, const std::size_t &)> &distance,
+        const _Distance &distance,
         const std::optional<std::vector<std::size_t>> initial = std::nullopt)
     {
         double dist = 0;
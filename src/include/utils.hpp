@@ -89,6 +89,46 @@ namespace utils
         }
     }
 
+    template <typename _Signature>
+    class FunctionRef;
+
+    /**
+     * @brief A non-owning, trivially copyable reference to a callable object.
+     *
+     * Unlike `std::function`, constructing a `FunctionRef` never allocates and invoking it costs
+     * exactly one indirect call. The referenced callable must outlive the `FunctionRef`.
+     */
+    template <typename _Result, typename... Args>
+    class FunctionRef<_Result(Args...)>
+    {
+    private:
+        void *_callable;
+        _Result (*_invoke)(void *, Args...);
+
+    public:
+        template <
+            typename _Function,
+            std::enable_if_t<
+                std::conjunction_v<
+                    std::negation<std::is_same<std::remove_cvref_t<_Function>, FunctionRef>>,
+                    std::is_invocable_r<_Result, _Function &, Args...>>,
+                bool> = true>
+        FunctionRef(_Function &&function)
+            : _callable(const_cast<void *>(static_cast<const void *>(std::addressof(function)))),
+              _invoke(
+                  [](void *callable, Args... args) -> _Result
+                  {
+                      return std::invoke(*static_cast<std::remove_reference_t<_Function> *>(callable), std::forward<Args>(args)...);
+                  })
+        {
+        }
+
+        _Result operator()(Args... args) const
+        {
+            return _invoke(_callable, std::forward<Args>(args)...);
+        }
+    };
+
     template <typename T>
     std::string type()
     {
@@ -195,6 +235,20 @@ namespace utils
             });
     }
 
+    /** @brief Parse the whole of `text` as a number, throw `std::invalid_argument` otherwise */
+    template <typename T, std::enable_if_t<std::is_arithmetic_v<T>, bool> = true>
+    T parse_number(const std::string_view &text)
+    {
+        T result;
+        auto [ptr, error] = std::from_chars(text.data(), text.data() + text.size(), result);
+        if (error != std::errc() || ptr != text.data() + text.size())
+        {
+            throw std::invalid_argument(format("Invalid number \"%s\"", std::string(text).c_str()));
+        }
+
+        return result;
+    }
+
     /**
      * @brief Get the size of the console window using
      * [`GetConsoleScreenBufferInfo`](https://learn.microsoft.com/en-us/windows/console/getconsolescreenbufferinfo)
@@ -1,11 +1,87 @@
 #include <solutions.hpp>
 
-int main()
+#ifdef TRACK_ALLOCATIONS
+// Attribute every heap allocation to the current instrumentation zone, see `utils::AllocationTracker`.
+// The operators are kept out of line so that GCC does not report the malloc/free pairs as mismatched
+// with new/delete.
+
+__attribute__((noinline)) void *operator new(std::size_t size)
+{
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    utils::AllocationTracker::allocate(ptr, size);
+    return ptr;
+}
+
+__attribute__((noinline)) void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+__attribute__((noinline)) void operator delete(void *ptr) noexcept
+{
+    utils::AllocationTracker::deallocate(ptr);
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete[](void *ptr) noexcept
+{
+    operator delete(ptr);
+}
+
+__attribute__((noinline)) void operator delete(void *ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+__attribute__((noinline)) void operator delete[](void *ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+#endif
+
+int main(int argc, char **argv)
 {
     d2d::Logger<d2d::Solution> logger;
     utils::PerformanceBenchmark benchmark("Elapsed");
 
-    auto problem = d2d::Problem::get_instance();
+    // Read the problem from stdin (scripts/in.py) unless it is specified on the command line
+    d2d::Problem *problem;
+    try
+    {
+        problem = argc > 1 ? d2d::Problem::load(argc, argv) : d2d::Problem::get_instance();
+
+        if (!problem->output_path.empty())
+        {
+            logger.open_output(problem->output_path);
+        }
+        if (!problem->trace_path.empty())
+        {
+            logger.open_trace(problem->trace_path);
+        }
+        if (!problem->profile_path.empty() || utils::AllocationTracker::enabled)
+        {
+            utils::Instrumentation::open(problem->profile_path, problem->profile_level);
+        }
+        if (!problem->control_path.empty())
+        {
+            utils::Interruption::watch(problem->control_path);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        utils::Instrumentation::close();
+        std::cerr << d2d::Problem::usage(argv[0]) << argv[0] << ": error: " << e.what() << std::endl;
+        return 2;
+    }
+
+    // On interruption, the search stops and the best solution so far is reported as usual
+    utils::Interruption::install_signal_handlers();
+
     std::shared_ptr<d2d::Solution> ptr;
     if (problem->evaluate.has_value())
     {
@@ -29,17 +105,23 @@ int main()
             }
         }
 
-        ptr = std::make_shared<d2d::Solution>(_truck_routes, _drone_routes, std::make_shared<d2d::ParentInfo<d2d::Solution>>(nullptr, "evaluate"));
+        ptr = d2d::Solution::create(_truck_routes, _drone_routes, std::make_shared<d2d::ParentInfo<d2d::Solution>>(nullptr, "evaluate"));
     }
     else
     {
         ptr = d2d::Solution::tabu_search(logger);
     }
 
+    if (utils::Interruption::requested())
+    {
+        std::cerr << "Interrupted, reporting the best solution so far" << std::endl;
+    }
+
     std::cerr << "\e[31mResult = " << ptr->cost() << "\e[0m" << std::endl;
 
     logger.elapsed = benchmark.elapsed<std::chrono::milliseconds>();
-    logger.finalize(ptr);
+    const bool written = logger.finalize(ptr);
+    utils::Instrumentation::close();
 
-    return 0;
+    return written ? 0 : 1;
 }